@@ -15,6 +15,7 @@
 #include <algorithm>
 #include <vector>
 #include <cassert>
+#include <cstdint>
 
 
 
@@ -112,7 +113,7 @@ class Graph {
 
   /** Construct an empty graph. */
 
-  Graph() : vect_nodes_(), vect_edges_() {
+  Graph() : vect_nodes_(), vect_edges_(), edge_slots_() {
 
     // HW0: YOUR CODE HERE
 
@@ -569,34 +570,17 @@ class Graph {
    * @pre @a a and @a b are valid nodes of this graph
    * @return True if for some @a i, edge(@a i) connects @a a and @a b.
    *
-   * Complexity: No more than O(num_nodes() + num_edges()), hopefully less
+   * Complexity: O(1) expected
    */
 
   bool has_edge(const Node& a, const Node& b) const {
 
     // HW0: YOUR CODE HERE
 
-    size_type  i=0;
-
-    while (i<num_edges()){
-
-        if (node(vect_edges_[i].node1_idx_) == a && node(vect_edges_[i].node2_idx_) == b){
-
-            return true;
-
-        }
+    // The edge index is looked up in the hash table edge_slots_ instead of
+    // scanning vect_edges_, so this is O(1) expected
 
-        else if (node(vect_edges_[i].node1_idx_) == b && node(vect_edges_[i].node2_idx_) == a){
-
-            return true;
-
-        }
-
-        i++;
-
-    }
-
-    return false;
+    return find_edge_(a.node_idx_, b.node_idx_) != num_edges();
 
   }
 
@@ -622,7 +606,7 @@ class Graph {
 
    *
 
-   * Complexity: No more than O(num_nodes() + num_edges()), hopefully less
+   * Complexity: O(1) expected, amortized over table growth
 
    */
 
@@ -631,29 +615,12 @@ class Graph {
     // HW0: YOUR CODE HERE
 
 
-    if (has_edge(a,b) == true){
-
-       // Here, we look for the index of this edge, in order to return 
-       // edge(this,index) 
-
-        size_type i =0;
-        while (i<num_edges()){
-
-             size_type node1_idx = vect_edges_[i].node1_idx_;
-             size_type node2_idx = vect_edges_[i].node2_idx_;
+    // One hash lookup both tells us if the edge exists and gives its index
 
-             if (node(node1_idx) == a && node(node2_idx) == b){
+    size_type i = find_edge_(a.node_idx_, b.node_idx_);
 
-                 break;
-              }
+    if (i != num_edges()){
 
-             else if (node(node1_idx) == b && node(node2_idx) == a){
-
-                 break;
-              }
-              i++;
-
-        }
          return Edge(this,i);
     }
 
@@ -662,6 +629,8 @@ class Graph {
 
         vect_edges_.push_back(internal_edge(num_edges(),a.node_idx_,b.node_idx_));
 
+        index_edge_(num_edges()-1);
+
         return Edge(this,num_edges()-1);
 
     }
@@ -688,6 +657,8 @@ class Graph {
 
     vect_edges_.clear();
 
+    edge_slots_.clear();
+
   }
 
 
@@ -926,6 +897,92 @@ class Graph {
 // vector of edges
   std::vector<internal_edge> vect_edges_;
 
+// Open-addressing (linear probing) hash table over the edges, keyed on the
+// unordered pair (min node index, max node index). A slot holds
+// edge index + 1, or 0 when empty. The size is a power of two and is kept
+// at least twice num_edges().
+  std::vector<size_type> edge_slots_;
+
+
+// Hash of the unordered pair {a, b}, reduced to a slot of edge_slots_
+
+  size_type edge_hash_(size_type a, size_type b) const {
+
+    if (b < a) std::swap(a, b);
+
+    std::uint64_t key = (std::uint64_t(a) << 32) | std::uint64_t(b);
+
+    key *= 0x9E3779B97F4A7C15ull;
+
+    return size_type(key >> 32) & size_type(edge_slots_.size() - 1);
+
+  }
+
+
+// Return the index of the edge joining node indices a and b, or num_edges()
+// if there is none. O(1) expected.
+
+  size_type find_edge_(size_type a, size_type b) const {
+
+    if (edge_slots_.empty()) return num_edges();
+
+    size_type mask = edge_slots_.size() - 1;
+
+    for (size_type s = edge_hash_(a, b); edge_slots_[s] != 0; s = (s + 1) & mask){
+
+        const internal_edge& e = vect_edges_[edge_slots_[s] - 1];
+
+        if ((e.node1_idx_ == a && e.node2_idx_ == b) || (e.node1_idx_ == b && e.node2_idx_ == a)){
+
+            return edge_slots_[s] - 1;
+        }
+    }
+
+    return num_edges();
+
+  }
+
+
+// Insert edge index i (already stored in vect_edges_) into edge_slots_,
+// doubling the table when it would become more than half full
+
+  void index_edge_(size_type i) {
+
+    if (2 * num_edges() > edge_slots_.size()){
+
+        edge_slots_.assign(edge_slots_.empty() ? 16 : 2 * edge_slots_.size(), 0);
+
+        for (size_type j = 0; j < num_edges(); j++){
+
+            insert_slot_(j);
+        }
+    }
+
+    else {
+
+        insert_slot_(i);
+    }
+
+  }
+
+
+// Place edge index i in the first free slot of its probe sequence
+
+  void insert_slot_(size_type i) {
+
+    size_type mask = edge_slots_.size() - 1;
+
+    size_type s = edge_hash_(vect_edges_[i].node1_idx_, vect_edges_[i].node2_idx_);
+
+    while (edge_slots_[s] != 0){
+
+        s = (s + 1) & mask;
+    }
+
+    edge_slots_[s] = i + 1;
+
+  }
+
 
 
 
@@ -56,6 +56,8 @@ class Graph {
   size_type next_edge_id_; //next edge number 
   std::map<unsigned, internal_node*> elements_; //map for fast insertion/deletion of nodes
   std::map<unsigned, internal_edge*> edges_; //map for fast insertion/deletion of edges
+  std::vector<size_type> degrees_; //degree of each node, indexed by uid
+  std::vector<size_type> degree_count_ = {0}; //number of nodes of each degree, up to the max
 
   // Disable copy and assignment of a Graph (not used)
   //Graph(const Graph&) = delete;
@@ -162,7 +164,15 @@ class Graph {
     // Supply definitions AND SPECIFICATIONS for:
     // node_value_type& value();
     // const node_value_type& value() const;
-    // size_type degree() const;
+
+    /** Return the number of edges incident to this node.
+     *
+     * Complexity: O(1).
+     */
+    size_type degree() const {
+      return graph_->degrees_[uid_];
+    }
+
     // incident_iterator edge_begin() const;
     // incident_iterator edge_end() const;
 
@@ -245,6 +255,8 @@ class Graph {
     new_element->uid = next_uid_;
     // insertion by iterator for constant amortized time insertion 
     current_it_ = elements_.insert(current_it_, std::make_pair(next_uid_,new_element));  \
+    degrees_.push_back(0); //new node has no edges yet
+    ++degree_count_[0];
     ++size_; //increment graph size
     ++next_uid_;  //next uid for next inserted node
     return Node(this, next_uid_ - 1);    
@@ -419,9 +431,29 @@ class Graph {
     // add a and b as neighbors to each other
     elements_[a.index()]->neighbors.push_back(b.index());
     elements_[b.index()]->neighbors.push_back(a.index());
+    increment_degree(a.index());
+    increment_degree(b.index());
     return Edge(this, next_edge_id_ - 1); 
   }
 
+  /** Return the largest degree of any node, or 0 for an empty graph.
+   *
+   * Complexity: O(1).
+   */
+  size_type max_degree() const {
+    return degree_count_.size() - 1;
+  }
+
+  /** Return the degree histogram of the graph.
+   * @return vector h with h[d] the number of nodes of degree d, for
+   *         0 <= d <= max_degree()
+   *
+   * Maintained as edges are added. Complexity: O(1).
+   */
+  const std::vector<size_type>& degree_histogram() const {
+    return degree_count_;
+  }
+
   /** Remove all nodes and edges from this graph.
    * @post num_nodes() == 0 && num_edges() == 0
    *
@@ -538,6 +570,14 @@ class Graph {
   // Use this space for your Graph class's internals:
   //   helper functions, data members, and so forth.
 
+  /** Add one to the degree of node @a uid and update the histogram. */
+  void increment_degree(size_type uid) {
+    size_type d = degrees_[uid]++;
+    --degree_count_[d];
+    if (d + 1 == degree_count_.size()) degree_count_.push_back(0);
+    ++degree_count_[d + 1];
+  }
+
 };
 
 #endif // CME212_GRAPH_HPP
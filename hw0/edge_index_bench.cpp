@@ -0,0 +1,65 @@
+/** @file edge_index_bench.cpp
+ * @brief add_edge() time of Graph_2866.hpp against the number of edges.
+ *
+ * Builds 3D grid meshes of growing side and times the add_edge() calls
+ * that connect every node to its +x, +y and +z neighbors, then a second
+ * pass that adds the same edges again, which only looks them up. With the
+ * hashed edge index both passes grow linearly with the edge count: the
+ * time per edge printed for each mesh only creeps up once the table no
+ * longer fits in cache, where a scan of the edge list would make it grow
+ * in proportion to the mesh.
+ *
+ * Build: g++ -std=c++14 -O3 -I<dir with CME212/> edge_index_bench.cpp
+ * Usage: ./a.out [max side]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+#include "Graph_2866.hpp"
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/** Add the edges from every node of a side^3 grid to its +x, +y, +z neighbors. */
+void link_grid(Graph& g, int side) {
+  int n = side * side * side;
+  for (int c = 0; c < n; ++c) {
+    int x = c % side, y = c / side % side, z = c / (side * side);
+    if (x + 1 < side) g.add_edge(g.node(c), g.node(c + 1));
+    if (y + 1 < side) g.add_edge(g.node(c), g.node(c + side));
+    if (z + 1 < side) g.add_edge(g.node(c), g.node(c + side * side));
+  }
+}
+
+int main(int argc, char** argv) {
+  int max_side = argc > 1 ? std::atoi(argv[1]) : 128;
+
+  std::cout << "     edges   insert s  ns/edge   lookup s  ns/edge\n";
+  for (int side = 8; side <= max_side; side *= 2) {
+    Graph g;
+    int n = side * side * side;
+    for (int c = 0; c < n; ++c)
+      g.add_node(Point(c % side, c / side % side, c / (side * side)));
+
+    auto start = std::chrono::steady_clock::now();
+    link_grid(g, side);
+    double insert = seconds_since(start);
+    double edges = g.num_edges();
+
+    start = std::chrono::steady_clock::now();
+    link_grid(g, side);  // every edge exists already
+    double lookup = seconds_since(start);
+    if (g.num_edges() != edges) std::cout << "duplicate edges added\n";
+
+    std::cout << std::setw(10) << g.num_edges() << std::fixed
+              << std::setw(11) << std::setprecision(4) << insert
+              << std::setw(9) << std::setprecision(1) << insert / edges * 1e9
+              << std::setw(11) << std::setprecision(4) << lookup
+              << std::setw(9) << std::setprecision(1) << lookup / edges * 1e9 << "\n";
+  }
+  return 0;
+}
@@ -302,6 +302,52 @@ public:
   	return n_it;
   }
 
+  /** Index reported by remove_nodes() and remove_nodes_if() for a node that
+  was removed. **/
+  static constexpr size_type removed_index = size_type(-1);
+
+  /** Remove every node in the range [first, last) in one pass.
+  * @param[in] first, last a range of Node objects (e.g. a node_iterator range
+  *   or a std::vector<Node>); nodes not in this graph are ignored.
+  * @return a vector @a new_index with one entry per old node index:
+  *   new_index[i] is the index node i has after the removal, or
+  *   removed_index if node i was removed.
+  * @post Surviving nodes keep their relative order, and all edges incident
+  *   to a removed node are removed.
+  *
+  * Invalidates all outstanding Node, Edge and iterator objects. Callers that
+  * keep per-node arrays can permute them once with the returned vector.
+  *
+  * Complexity: O(num_nodes() + num_edges()) regardless of how many nodes
+  * are removed, instead of O(num_nodes() + num_edges()) per removed node.
+  */
+  template <typename NodeIter>
+  std::vector<size_type> remove_nodes(NodeIter first, NodeIter last){
+  	std::vector<char> removed(size(), 0);
+  	for (; first != last; ++first){
+  		Node n = *first;
+  		if (has_node(n)){
+  			removed[n.index()] = 1;
+  		}
+  	}
+  	return compact_nodes(removed);
+  }
+
+  /** Remove every node n for which pred(n) is true, in one pass.
+  * @return the old-to-new index mapping, as for remove_nodes().
+  *
+  * @a pred is called once per node, before anything is removed.
+  * Complexity: O(num_nodes() + num_edges()) plus the predicate calls.
+  */
+  template <typename Pred>
+  std::vector<size_type> remove_nodes_if(Pred pred){
+  	std::vector<char> removed(size(), 0);
+  	for (size_type i = 0; i<size(); i++){
+  		removed[i] = pred(node(i)) ? 1 : 0;
+  	}
+  	return compact_nodes(removed);
+  }
+
   //
   // EDGES
   //
@@ -517,6 +563,48 @@ public:
   	return e_it;
   }
 
+  /** Remove every edge e for which pred(e) is true, in one pass.
+  * @return the number of edges removed.
+  * @post Node indices are unchanged.
+  *
+  * @a pred is called once per edge, in edge_begin() order, before anything
+  * is removed, so it may read edge values and node data freely.
+  * Invalidates outstanding Edge and iterator objects.
+  *
+  * Complexity: O(num_nodes() + num_edges() log(max degree)) plus the
+  * predicate calls.
+  */
+  template <typename Pred>
+  size_type remove_edges_if(Pred pred){
+  	// Collect the positions of both copies of each rejected edge first, so
+  	// every predicate sees the untouched graph.
+  	std::vector<std::pair<size_type, size_type>> victims;
+  	for (size_type i = 0; i<size(); i++){
+  		for (size_type j = 0; j<Node_sets[i].degree; j++){
+  			size_type k = Edge_sets[i][j].neighbor_index;
+  			if (pred(Edge(this, i, k))){
+  				auto location = std::lower_bound(Edge_sets[k].begin(), Edge_sets[k].end(), Edge_set(i));
+  				victims.push_back(std::make_pair(i, j));
+  				victims.push_back(std::make_pair(k, size_type(location - Edge_sets[k].begin())));
+  			}
+  		}
+  	}
+  	for (auto& v : victims){
+  		Edge_sets[v.first][v.second].neighbor_index = removed_index;
+  	}
+
+  	// One compaction pass over all adjacency lists.
+  	for (size_type i = 0; i<size(); i++){
+  		auto& edges = Edge_sets[i];
+  		edges.erase(std::remove_if(edges.begin(), edges.end(), [](const Edge_set& e){
+  			return e.neighbor_index == removed_index;
+  		}), edges.end());
+  		Node_sets[i].degree = std::lower_bound(edges.begin(), edges.end(), Edge_set(i)) - edges.begin();
+  	}
+  	number_edges -= victims.size()/2;
+  	return victims.size()/2;
+  }
+
   //
   // Node Iterator
   //
@@ -691,6 +779,50 @@ public:
   }
 
  private:
+  /** Shared implementation of remove_nodes() and remove_nodes_if().
+  * @param[in] removed removed[i] is nonzero if node i is to be removed
+  * @return the old-to-new index mapping
+  *
+  * The mapping is increasing on surviving nodes, so each adjacency list
+  * stays sorted after it is filtered and renumbered in place.
+  */
+  std::vector<size_type> compact_nodes(const std::vector<char>& removed){
+  	std::vector<size_type> new_index(size(), size_type(removed_index));
+  	size_type next = 0;
+  	for (size_type i = 0; i<size(); i++){
+  		if (!removed[i]){
+  			new_index[i] = next++;
+  		}
+  	}
+
+  	number_edges = 0;
+  	for (size_type i = 0; i<size(); i++){
+  		if (removed[i]){
+  			continue;
+  		}
+  		auto& edges = Edge_sets[i];
+  		size_type kept = 0;
+  		for (size_type j = 0; j<edges.size(); j++){
+  			size_type k = new_index[edges[j].neighbor_index];
+  			if (k != removed_index){
+  				edges[kept] = edges[j];
+  				edges[kept].neighbor_index = k;
+  				kept++;
+  			}
+  		}
+  		edges.resize(kept);
+  		Node_sets[i].degree = std::lower_bound(edges.begin(), edges.end(), Edge_set(new_index[i])) - edges.begin();
+  		number_edges += Node_sets[i].degree;
+  		if (new_index[i] != i){
+  			Node_sets[new_index[i]] = Node_sets[i];
+  			Edge_sets[new_index[i]] = std::move(edges);
+  		}
+  	}
+  	Node_sets.erase(Node_sets.begin()+next, Node_sets.end());
+  	Edge_sets.resize(next);
+  	return new_index;
+  }
+
   /** Node_sets are a vector of Node_set, where Node_set is 
   an internal class that stores the identity and position of the node.
   Node_sets[i], i is the ith node in terms of index on the graph.**/
@@ -0,0 +1,273 @@
+#ifndef CME212_EXECUTOR_HPP
+#define CME212_EXECUTOR_HPP
+
+/** @file Executor.hpp
+ * @brief Work-stealing parallel loops over the nodes and edges of a Graph
+ */
+
+#include <algorithm>
+#include <vector>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <utility>
+
+
+/** @struct ExecutorStats
+ * @brief What one thread did during the last Executor loop.
+ */
+struct ExecutorStats {
+  double busy = 0;          // seconds spent running chunks
+  std::size_t chunks = 0;   // chunks run
+  std::size_t stolen = 0;   // of those, chunks taken from another thread
+  std::size_t items = 0;    // nodes or edges visited
+  std::size_t weight = 0;   // sum of their weights (degree + 1 for nodes)
+};
+
+inline std::ostream& operator<<(std::ostream& os, const std::vector<ExecutorStats>& stats) {
+  for (std::size_t t = 0; t < stats.size(); ++t)
+    os << "thread " << t << ": " << stats[t].busy << " s, " << stats[t].chunks
+       << " chunks (" << stats[t].stolen << " stolen), " << stats[t].items
+       << " items, weight " << stats[t].weight << "\n";
+  return os;
+}
+
+
+/** @class Executor
+ * @brief Thread pool that runs loops over node and edge index ranges with
+ *        work stealing.
+ *
+ * A loop is cut into about 8 chunks per thread. Node loops are cut by
+ * cumulative weight degree() + 1 rather than by node count, so a few hub
+ * nodes do not pile their incident-edge work onto one thread. Each thread
+ * starts with a contiguous run of chunks and takes from its front; a
+ * thread that runs out steals from the back of another's queue.
+ *
+ * The calling thread works as thread 0, so Executor(n) starts n - 1
+ * workers. stats() has one entry per thread for the last loop.
+ * Loops must not be started from inside a loop body, and one Executor
+ * runs one loop at a time.
+ *
+ * G needs num_nodes(), node(i) with Node::degree(), num_edges() and
+ * edge(i), as hw2/Graph_2259.hpp has. The body is called concurrently
+ * and must not add or remove nodes or edges.
+ *
+ * @code
+ * Executor ex;
+ * for_each_node(graph, [](Node n) { ... }, ex);
+ * std::cout << ex.stats();
+ * @endcode
+ */
+class Executor {
+ public:
+  /** Start a pool of @a threads threads including the caller, or one per
+   *  hardware thread if 0.
+   */
+  explicit Executor(unsigned threads = 0)
+      : threads_(threads ? threads : std::max(1u, std::thread::hardware_concurrency())),
+        stats_(threads_) {
+    for (unsigned t = 0; t < threads_; ++t)
+      queues_.emplace_back(new queue());
+    for (unsigned t = 1; t < threads_; ++t)
+      pool_.emplace_back([this, t]() { serve(t); });
+  }
+
+  /** Stop and join the workers. */
+  ~Executor() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& th : pool_) th.join();
+  }
+
+  Executor(const Executor&) = delete;
+  Executor& operator=(const Executor&) = delete;
+
+  /** Return the number of threads, the caller included. */
+  unsigned num_threads() const { return threads_; }
+
+  /** Return per-thread statistics of the last loop. */
+  const std::vector<ExecutorStats>& stats() const { return stats_; }
+
+  /** Call f(graph.node(i)) for every node, in parallel.
+   *
+   * Complexity: O(num_nodes()) to cut the chunks, plus the body's work
+   * divided over the threads.
+   */
+  template <typename G, typename F>
+  void for_each_node(const G& graph, F f) {
+    std::size_t n = graph.num_nodes();
+    std::vector<std::size_t> prefix(n + 1, 0);
+    for (std::size_t i = 0; i < n; ++i)
+      prefix[i + 1] = prefix[i] + graph.node(i).degree() + 1;
+    run(cut(prefix), [&graph, &f, &prefix](std::size_t b, std::size_t e, ExecutorStats& s) {
+      for (std::size_t i = b; i < e; ++i) f(graph.node(i));
+      s.weight += prefix[e] - prefix[b];
+    });
+  }
+
+  /** Call f(graph.edge(i)) for every edge, in parallel.
+   *
+   * Edges all weigh the same, so chunks have equal edge counts.
+   */
+  template <typename G, typename F>
+  void for_each_edge(const G& graph, F f) {
+    std::size_t m = graph.num_edges();
+    std::vector<std::size_t> prefix(m + 1);
+    for (std::size_t i = 0; i <= m; ++i) prefix[i] = i;
+    run(cut(prefix), [&graph, &f](std::size_t b, std::size_t e, ExecutorStats& s) {
+      for (std::size_t i = b; i < e; ++i) f(graph.edge(i));
+      s.weight += e - b;
+    });
+  }
+
+ private:
+  using clock = std::chrono::steady_clock;
+  using range = std::pair<std::size_t, std::size_t>;
+  using body_type = std::function<void(std::size_t, std::size_t, ExecutorStats&)>;
+
+  struct queue {
+    std::mutex mutex;
+    std::deque<range> chunks;
+  };
+
+  unsigned threads_;
+  std::vector<ExecutorStats> stats_;
+  std::vector<std::unique_ptr<queue>> queues_;
+  std::vector<std::thread> pool_;
+
+  // Loop hand-off: run() bumps round_ and waits until every worker has
+  // finished that round
+  std::mutex mutex_;
+  std::condition_variable wake_, done_;
+  body_type body_;
+  std::size_t round_ = 0;
+  unsigned finished_ = 0;
+  bool stop_ = false;
+
+  /** Cut [0, n) into about 8 chunks per thread of equal weight, where
+   *  @a prefix[i] is the total weight of items before i.
+   */
+  std::vector<range> cut(const std::vector<std::size_t>& prefix) const {
+    std::size_t n = prefix.size() - 1;
+    std::size_t k = std::min<std::size_t>(8 * threads_, n);
+    std::vector<range> chunks;
+    std::size_t begin = 0;
+    for (std::size_t c = 1; c <= k; ++c) {
+      // first item at which the weight so far reaches c / k of the total
+      std::size_t target = prefix[n] * c / k;
+      std::size_t end = c == k ? n
+          : std::size_t(std::lower_bound(prefix.begin() + begin, prefix.end(), target) - prefix.begin());
+      if (end > begin) chunks.push_back(range(begin, end));
+      begin = std::max(begin, end);
+    }
+    return chunks;
+  }
+
+  /** Run @a body on every chunk, with thread t starting on the t-th
+   *  contiguous share of them, and return when all are done.
+   */
+  void run(const std::vector<range>& chunks, body_type body) {
+    for (unsigned t = 0; t < threads_; ++t) {
+      stats_[t] = ExecutorStats();
+      std::size_t b = chunks.size() * t / threads_, e = chunks.size() * (t + 1) / threads_;
+      queues_[t]->chunks.assign(chunks.begin() + b, chunks.begin() + e);
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      body_ = std::move(body);
+      finished_ = 0;
+      ++round_;
+    }
+    wake_.notify_all();
+    work(0);
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this]() { return finished_ == threads_ - 1; });
+  }
+
+  /** Worker loop of thread @a t: run each round, then report it done. */
+  void serve(unsigned t) {
+    std::size_t seen = 0;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_.wait(lock, [this, seen]() { return stop_ || round_ != seen; });
+        if (stop_) return;
+        seen = round_;
+      }
+      work(t);
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++finished_;
+      }
+      done_.notify_one();
+    }
+  }
+
+  /** Run chunks as thread @a t until no queue has any left. */
+  void work(unsigned t) {
+    ExecutorStats& s = stats_[t];
+    range r;
+    bool stolen;
+    while (take(t, r, stolen)) {
+      auto start = clock::now();
+      body_(r.first, r.second, s);
+      s.busy += std::chrono::duration<double>(clock::now() - start).count();
+      ++s.chunks;
+      s.stolen += stolen;
+      s.items += r.second - r.first;
+    }
+  }
+
+  /** Take the next chunk for thread @a t: the front of its own queue, or
+   *  else the back of the first other nonempty queue.
+   */
+  bool take(unsigned t, range& r, bool& stolen) {
+    for (unsigned k = 0; k < threads_; ++k) {
+      queue& q = *queues_[(t + k) % threads_];
+      std::lock_guard<std::mutex> lock(q.mutex);
+      if (q.chunks.empty()) continue;
+      if (k == 0) {
+        r = q.chunks.front();
+        q.chunks.pop_front();
+      } else {
+        r = q.chunks.back();
+        q.chunks.pop_back();
+      }
+      stolen = k != 0;
+      return true;
+    }
+    return false;
+  }
+};
+
+/** Return the pool used by for_each_node() and for_each_edge() when no
+ *  Executor is given; it has one thread per hardware thread.
+ */
+inline Executor& default_executor() {
+  static Executor executor;
+  return executor;
+}
+
+/** Call f(node) for every node of @a graph in parallel. */
+template <typename G, typename F>
+void for_each_node(const G& graph, F f, Executor& executor = default_executor()) {
+  executor.for_each_node(graph, f);
+}
+
+/** Call f(edge) for every edge of @a graph in parallel. */
+template <typename G, typename F>
+void for_each_edge(const G& graph, F f, Executor& executor = default_executor()) {
+  executor.for_each_edge(graph, f);
+}
+
+#endif // CME212_EXECUTOR_HPP
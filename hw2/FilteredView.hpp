@@ -0,0 +1,152 @@
+#ifndef CME212_FILTEREDVIEW_HPP
+#define CME212_FILTEREDVIEW_HPP
+
+/** @file FilteredView.hpp
+ * @brief A subgraph view that hides the nodes rejected by a predicate
+ */
+
+#include <iterator>
+#include <utility>
+
+
+/** @class filter_iterator
+ * @brief Iterator adaptor that skips the elements rejected by @a Keep.
+ *
+ * Wraps an iterator range [it, end) of a Graph and stops only on elements
+ * x with keep(*x) true.
+ */
+template <typename It, typename Keep>
+class filter_iterator {
+ public:
+  // These type definitions let us use STL's iterator_traits.
+  using value_type        = typename std::iterator_traits<It>::value_type;
+  using pointer           = typename std::iterator_traits<It>::pointer;
+  using reference         = typename std::iterator_traits<It>::reference;
+  using difference_type   = typename std::iterator_traits<It>::difference_type;
+  using iterator_category = std::input_iterator_tag;  // Proxy
+
+  /** Construct an iterator at the first kept element of [@a it, @a end). */
+  filter_iterator(const It& it, const It& end, const Keep& keep)
+      : it_(it), end_(end), keep_(keep) {
+    skip();
+  }
+
+  value_type operator*() const { return *it_; }
+
+  filter_iterator& operator++() {
+    ++it_;
+    skip();
+    return *this;
+  }
+
+  bool operator==(const filter_iterator& x) const { return it_ == x.it_; }
+  bool operator!=(const filter_iterator& x) const { return !(it_ == x.it_); }
+
+ private:
+  It it_;
+  It end_;
+  Keep keep_;
+
+  /** Advance to the next kept element, or to end. */
+  void skip() {
+    while (!(it_ == end_) && !keep_(*it_))
+      ++it_;
+  }
+};
+
+
+/** @class FilteredView
+ * @brief Read-only view of the subgraph induced by the nodes of a Graph
+ *        that satisfy a predicate.
+ *
+ * Nothing is copied: the view holds a pointer to the graph and the
+ * predicate, and its iterators skip rejected nodes and every edge with a
+ * rejected endpoint while walking the graph's own iterators. They yield
+ * the graph's own Node and Edge objects, which stay usable with the graph.
+ * The predicate is evaluated on each step, so it should be cheap and must
+ * not change while the view is in use. Iterators refer to the view's
+ * predicate and must not outlive the view.
+ *
+ * ShortestPath can search a view directly (see ShortestPath.hpp).
+ *
+ * @code
+ * auto upper = filtered_view(graph, [](const Node& n) { return n.position().z > 0; });
+ * for (auto it = upper.node_begin(); it != upper.node_end(); ++it) ...
+ * @endcode
+ */
+template <typename G, typename Pred>
+class FilteredView {
+ public:
+  using graph_type = G;
+  using node_type = typename G::node_type;
+  using edge_type = typename G::edge_type;
+  using size_type = typename G::size_type;
+
+ private:
+  /** Keep edges whose endpoints are both in the view. */
+  struct edge_keep {
+    const Pred* pred;
+    bool operator()(const edge_type& e) const {
+      return (*pred)(e.node1()) && (*pred)(e.node2());
+    }
+  };
+  /** Keep nodes in the view. */
+  struct node_keep {
+    const Pred* pred;
+    bool operator()(const node_type& n) const { return (*pred)(n); }
+  };
+
+ public:
+  using node_iterator = filter_iterator<typename G::node_iterator, node_keep>;
+  using edge_iterator = filter_iterator<typename G::edge_iterator, edge_keep>;
+  using incident_iterator = filter_iterator<typename G::incident_iterator, edge_keep>;
+
+  /** Construct a view of the nodes of @a graph accepted by @a pred.
+   *  The graph must outlive the view.
+   */
+  FilteredView(const G& graph, Pred pred) : graph_(&graph), pred_(std::move(pred)) {}
+
+  /** Return the underlying graph. */
+  const G& graph() const { return *graph_; }
+
+  /** Return true if node @a n of the graph is part of this view. */
+  bool contains(const node_type& n) const { return pred_(n); }
+
+  /** Iterate over the nodes in the view. */
+  node_iterator node_begin() const {
+    return node_iterator(graph_->node_begin(), graph_->node_end(), node_keep{&pred_});
+  }
+  node_iterator node_end() const {
+    return node_iterator(graph_->node_end(), graph_->node_end(), node_keep{&pred_});
+  }
+
+  /** Iterate over the edges with both endpoints in the view. */
+  edge_iterator edge_begin() const {
+    return edge_iterator(graph_->edge_begin(), graph_->edge_end(), edge_keep{&pred_});
+  }
+  edge_iterator edge_end() const {
+    return edge_iterator(graph_->edge_end(), graph_->edge_end(), edge_keep{&pred_});
+  }
+
+  /** Iterate over the edges of @a n that stay in the view.
+   * @pre contains(@a n)
+   */
+  incident_iterator edge_begin(const node_type& n) const {
+    return incident_iterator(n.edge_begin(), n.edge_end(), edge_keep{&pred_});
+  }
+  incident_iterator edge_end(const node_type& n) const {
+    return incident_iterator(n.edge_end(), n.edge_end(), edge_keep{&pred_});
+  }
+
+ private:
+  const G* graph_;
+  Pred pred_;
+};
+
+/** Return a view of the nodes of @a graph accepted by @a pred. */
+template <typename G, typename Pred>
+FilteredView<G, Pred> filtered_view(const G& graph, Pred pred) {
+  return FilteredView<G, Pred>(graph, std::move(pred));
+}
+
+#endif // CME212_FILTEREDVIEW_HPP
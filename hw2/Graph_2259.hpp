@@ -9,6 +9,16 @@
 #include <vector>
 #include <cassert>
 #include <map>
+#include <cstddef>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <limits>
 
 #include "CME212/Util.hpp"
 #include "CME212/Point.hpp"
@@ -27,11 +37,10 @@ class Graph {
     // The Graph class contains all the information which the proxy classes
     // Node() and Edge() can map to, and therefore be lightweight.
 	
-	// Predeclare the internal node struct
-	struct internal_node;
-	
 	// Predeclare the internal edge struct
 	struct internal_edge;
+	// Predeclare the queue of moved nodes
+	struct moved_list;
  
  public:
 
@@ -83,6 +92,91 @@ class Graph {
   /** Type of EdgeIteratior*/
   using edge_iterator_type = typename std::vector<size_type>::const_iterator;
 
+  /** Node orderings understood by reorder(). */
+  enum class reorder_strategy {
+	  reverse_cuthill_mckee, // bandwidth-reducing BFS order of the adjacency
+	  morton                 // Z-order curve over node positions
+  };
+
+  /** @class Graph::Span
+   * @brief Non-owning view of a contiguous array of node or edge data.
+   *
+   * Returned by positions() and values(), where element i belongs to
+   * node(i), and by edge_lengths(), where element i belongs to edge(i).
+   * A Span is invalidated by add_node, remove_node and clear, and an edge
+   * Span also by add_edge and remove_edge.
+   */
+  template <typename T>
+  class Span {
+   public:
+	  /** Construct an empty Span. */
+	  Span() : data_(nullptr), size_(0) {}
+
+	  T* data() const { return data_; }
+	  size_type size() const { return size_; }
+	  T* begin() const { return data_; }
+	  T* end() const { return data_ + size_; }
+	  T& operator[](size_type i) const { return data_[i]; }
+
+   private:
+	  friend class Graph;
+	  T* data_;
+	  size_type size_;
+	  Span(T* data, size_type size) : data_(data), size_(size) {}
+  };
+
+  /** @class Graph::ColorClass
+   * @brief Read-only view of the nodes or edges of one color.
+   *
+   * Returned by node_color_class() and edge_color_class(). Element k is
+   * a Node or Edge (T) of the graph, so threads can split [0, size()).
+   * No two edges of one class share an endpoint and no two nodes of one
+   * class are adjacent, so work on different elements of a class never
+   * writes the same node. Invalidated by any change to the graph.
+   */
+  template <typename T>
+  class ColorClass {
+   public:
+	  /** Construct an empty class. */
+	  ColorClass() : gp_(nullptr), uids_(nullptr), size_(0) {}
+
+	  size_type size() const { return size_; }
+	  T operator[](size_type k) const { return gp_->by_uid(uids_[k], static_cast<T*>(nullptr)); }
+
+	  /** @class Graph::ColorClass::iterator
+	   * @brief Forward iterator over the elements of a color class. */
+	  class iterator {
+	   public:
+		  using value_type        = T;
+		  using pointer           = T*;
+		  using reference         = T&;
+		  using difference_type   = std::ptrdiff_t;
+		  using iterator_category = std::input_iterator_tag;
+
+		  T operator*() const { return (*c_)[k_]; }
+		  iterator& operator++() { ++k_; return *this; }
+		  bool operator==(const iterator& x) const { return k_ == x.k_ && c_ == x.c_; }
+		  bool operator!=(const iterator& x) const { return !(*this == x); }
+
+	   private:
+		  friend class ColorClass;
+		  const ColorClass* c_;
+		  size_type k_;
+		  iterator(const ColorClass* c, size_type k) : c_(c), k_(k) {}
+	  };
+
+	  iterator begin() const { return iterator(this, 0); }
+	  iterator end() const { return iterator(this, size_); }
+
+   private:
+	  friend class Graph;
+	  const Graph* gp_;
+	  const size_type* uids_;
+	  size_type size_;
+	  ColorClass(const Graph* gp, const std::vector<size_type>& uids)
+		  : gp_(gp), uids_(uids.data()), size_(uids.size()) {}
+  };
+
   //
   // CONSTRUCTORS AND DESTRUCTOR
   //
@@ -126,11 +220,9 @@ class Graph {
      * do_something(x);
      * @endcode
      */
-    Node() {
-        // Nothing needs to go in here because we don't need to
-        // do anything with a Node defined in this way. Calling
-        // Graph::Node::Node() will just create an empty node with
-        // no information, an invalid Node.
+    Node() : gp_(nullptr), index_(size_type(-1)), gen_(stale_generation) {
+        // Calling Graph::Node::Node() will just create an empty node
+        // with no information, an invalid Node.
         
         // See the private variables and constructor.
     }
@@ -142,21 +234,31 @@ class Graph {
         // use the vector of points and the index to get the
         // position
 		assert(valid());
-		const Point& p = gp_->points_[index_].p_;
+		const Point& p = gp_->positions_[gp_->node_index_[index_]];
 		return p;
     }
 	  
 	/** Return this node's position. Pass by reference so it can be modidfied
-	 *  @pre this is a valid node of this Graph.*/
+	 *  @pre this is a valid node of this Graph.
+	 *  @post cached edge lengths are stale until the next edge_lengths()
+	 *
+	 *  This node is marked as moved when the reference is handed out, so
+	 *  do not hold on to it across calls to edge_lengths() or spatial
+	 *  queries; they catch up with the marked nodes only. Marking sets an
+	 *  atomic flag of this node and, the first time, appends it to a
+	 *  lock-free list, so parallel node loops may call this at once.
+	 */
 	  Point& position () {
 		  assert(valid());
-		  Point& p = gp_->points_[index_].p_;
+		  size_type i = gp_->node_index_[index_];
+		  gp_->mark_moved(index_);
+		  Point& p = gp_->positions_[i];
 		  return p;
 	  }
 
     /** Return this node's index, a number in the range [0, graph_size). */
     size_type index() const {
-		size_type result = gp_->points_[index_].index_;
+		size_type result = gp_->node_index_[index_];
 		assert(result < gp_->num_active_points_);
       return result;
     }
@@ -169,20 +271,21 @@ class Graph {
 	   *  so it can be set by node.value() = val
 	   */
 	  node_value_type& value() {
-		  return gp_->points_.at(index_).val_;
+		  assert(valid());
+		  return gp_->values_[gp_->node_index_[index_]];
 	  }
 	  
 	  /** Return this node's value of type node_value_type. Read only. */
 	  const node_value_type& value() const {
-		  return gp_->points_.at(index_).val_;
+		  assert(valid());
+		  return gp_->values_[gp_->node_index_[index_]];
 	  }
 	  
 	  /** Return the number of nodes this node is connected to via
-	   *  a valid edge
+	   *  a valid edge. Complexity: O(1).
 	   */
 	  size_type degree() const {
-		  size_type result = (gp_->adj_map_.at(index_)).size();
-		  return result;
+		  return gp_->degrees_[gp_->node_index_[index_]];
 	  };
 	  
 	  /** Returns an IncidentIterator object for the beginning of the STL
@@ -216,7 +319,7 @@ class Graph {
         // of node n and they are part of the same
         // graph
 		assert(valid());
-		return (gp_->points_[index_].index_ == n.index() && (gp_ == n.gp()));
+		return (gp_->node_index_[index_] == n.index() && (gp_ == n.gp()));
     }
 
 	/** Test whether this node is less than @a n in a global order.
@@ -233,12 +336,23 @@ class Graph {
         // of node n. Needs to work even if they belong
         // to different graphs.
 		 assert(valid());
-        if (gp_->points_[index_].index_< n.index())
+        if (gp_->node_index_[index_]< n.index())
             return true;
 		else
 			return (std::less<const Graph*>{}(gp_, n.gp_));
     }
 
+	  /** Test whether this node is still a node of its graph
+	   * @return true iff the node's UID slot has the generation it had when
+	   *         this Node was made; remove_node() and clear() bump it
+	   *
+	   * Complexity: O(1), one array load.
+	   */
+	  bool valid() const {
+		  return gp_ != nullptr && index_ < gp_->node_gen_.size()
+		      && gp_->node_gen_[index_] == gen_;
+	  }
+
 
    private:
     // Allow Graph to access Node's private member data and functions.
@@ -252,32 +366,12 @@ class Graph {
       Graph* gp_;
       // int to store the index of the node in the graph's vector of Points
       const size_type index_; // UID
-      /** Private Constructor. Uses UID as index. */
+      // generation of UID slot index_ when this Node was made
+      size_type gen_;
+      /** Private Constructor. Uses UID as index. Valid iff that UID is live. */
       Node(const Graph* graph, int index)
-      : gp_(const_cast<Graph*>(graph)), index_(index) {}
-	  
-	  
-	  /** Function to test for invariants for Nodes
-	   * @brief Tests if this node has active index in the correct range, UID in the correct range,
-	   * and that the node is in sync for the containers @a points_ and @a i2u_nodes_
-	   * @return true if all invariants are passed, false if not, along with a printout of useful
-	   * diagnostic information for edbugging.
-	   */
-	  bool valid() const {
-		  if (!(index_ >=0 && index_ < gp_->points_.size())) {
-			  std::cout<<"UID out of range"<<std::endl;
-		  }
-		  else if (!(gp_->points_[index_].index_ < gp_->i2u_nodes_.size())) {
-			  std::cout<<"Active out of range"<<std::endl;
-		  }
-					else if (!(gp_->i2u_nodes_[(gp_->points_)[index_].index_] == index_)) {
-			  std::cout<<"Node UID "<<index_<<" out of sync; UID via points_ = "<<(gp_->i2u_nodes_)[(gp_->points_)[index_].index_]<<std::endl;
-						std::cout<<"Node active ID "<<(gp_->points_)[index_].index_<<std::endl;
-		  }
-		  return (index_ >=0 && index_ < gp_->points_.size())
-		  && (gp_->points_[index_].index_ < gp_->i2u_nodes_.size())
-		  && (gp_->i2u_nodes_[(gp_->points_)[index_].index_] == index_);
-	  }
+      : gp_(const_cast<Graph*>(graph)), index_(index),
+        gen_(graph->live_generation(graph->node_gen_, index)) {}
   };
 
   /** Return the number of nodes in the graph.
@@ -301,33 +395,7 @@ class Graph {
    * Complexity: O(1) amortized operations.
    */
   Node add_node(const Point& position) {
-	// Add the point to the vector of points which
-	// exists in the graph, and create an instance
-	// of the Node() class to return.
-	  
-	  // Declare internal_node containing the information for
-	  // the Graph class.
-	  internal_node in = {
-		.p_ = position,
-		.index_ = num_active_points_, // next active ID
-		.gp_ = this
-	  };
-      points_.push_back(in);
-	  
-	  // Add to the set of currently active nodes
-	  i2u_nodes_.push_back(num_points_); // i2u_nodes_[num_active_points_] == UID
-	  
-	  // Need to add an empty map to the adjacency map for this
-	  // node in case we try to invoke incident iterator on a
-	  // Node with no edges
-	  std::map<int, int> empty_map {};
-	  adj_map_[num_points_] = empty_map;
-	  assert(adj_map_[num_points_].empty());
-	  
-      Node n = Node(this, num_points_);
-      ++num_points_;
-	  ++num_active_points_;
-    return n;
+	  return add_node(position, node_value_type());
   }
 
 	Node add_node(const Point& position, const node_value_type& val) {
@@ -335,28 +403,38 @@ class Graph {
 	// exists in the graph, and create an instance
 	// of the Node() class to return.
 	  
-	  // Declare internal_node containing the information for
-	  // the Graph class.
-	  internal_node in = {
-		.p_ = position,
-		.index_ = num_active_points_, // next active ID
-		.gp_ = this,
-		.val_ = val
-	  };
-      points_.push_back(in);
+	  // Position and value are stored at the next active index; the
+	  // new UID, a freed one if any, maps to that active index.
+	  positions_.push_back(position);
+	  values_.push_back(val);
+	  degrees_.push_back(0);
+	  ++degree_count_[0];
+	  size_type uid = claim_uid(free_node_uids_, num_points_);
+	  if (uid == node_index_.size())
+		  node_index_.push_back(num_active_points_); // next active ID
+	  else
+		  node_index_[uid] = num_active_points_;
 	  
 	  // Add to the set of currently active nodes
-	  i2u_nodes_.push_back(num_points_); // i2u_nodes_[num_active_points_] == UID
+	  i2u_nodes_.push_back(uid); // i2u_nodes_[num_active_points_] == UID
+	  revive(node_gen_, uid);
+	  if (uid == node_moved_.size()) {
+		  node_moved_.emplace_back();
+		  lengths_moved_.uids.push_back(0);
+		  grid_moved_.uids.push_back(0);
+	  }
 	  
 	  // Need to add an empty map to the adjacency map for this
 	  // node in case we try to invoke incident iterator on a
 	  // Node with no edges
 	  std::map<int, int> empty_map {};
-	  adj_map_[num_points_] = empty_map;
-	  assert(adj_map_[num_points_].empty());
+	  adj_map_[uid] = empty_map;
+	  assert(adj_map_[uid].empty());
 		
-	  Node n = Node(this, num_points_);
-      ++num_points_;
+	  grid_touch(uid);
+	  if (coloring_built_)
+		  color_insert(node_color_, node_color_pos_, node_classes_, uid, 0);
+	  Node n = Node(this, uid);
 	  ++num_active_points_;
     return n;
 	}
@@ -365,12 +443,14 @@ class Graph {
   /** Determine if a Node belongs to this Graph
    * @return True if @a n is currently a Node of this Graph
    *
+   * A removed node's UID may have been reused by a later add_node(), so
+   * the generation is checked before the UID is looked up.
+   *
    * Complexity: O(1).
    */
   bool has_node(const Node& n) const {
-      // Is this node's active index in range,
-      // and are they pointing to the same graph?
-    return (n.index() >= 0) && (n.index() < num_active_points_) && (this==n.gp());
+      // Same graph, still live, and is its active index in range?
+    return (this==n.gp()) && n.valid() && (n.index() < num_active_points_);
   }
 
   /** Return the node with index @a i.
@@ -381,7 +461,7 @@ class Graph {
    */
   Node node(size_type i) const {
       // Construct a new Node pointing to this graph
-	  assert(points_[i2u_nodes_[i]].index_==i);
+	  assert(node_index_[i2u_nodes_[i]]==i);
     return Node(this, i2u_nodes_[i]);
   }
 	
@@ -434,9 +514,22 @@ class Graph {
 	  size_type n_UID = i2u_nodes_[n.index()];
 	  assert(adj_map_[n_UID].empty());
 	  adj_map_.erase(n_UID);
+	  grid_erase(n_UID);
+	  if (coloring_built_)
+		  color_erase(node_color_, node_color_pos_, node_classes_, n_UID);
+	  ++node_gen_[n_UID];
+	  free_node_uids_.push_back(n_UID);
 	  
-	  // Change active index for the node being swapped in
-	  points_[swap_uid].index_ = result;
+	  // Change active index for the node being swapped in, and move its
+	  // position and value into the vacated slot
+	  node_index_[swap_uid] = result;
+	  positions_[result] = positions_.back();
+	  positions_.pop_back();
+	  --degree_count_[0]; // all its edges are gone
+	  degrees_[result] = degrees_.back();
+	  degrees_.pop_back();
+	  values_[result] = values_.back();
+	  values_.pop_back();
 	  
 	  // Remove node from containter of active nodes. The node with the
 	  // highest index (==num_active_points_-1) will now have this node's
@@ -464,9 +557,8 @@ class Graph {
   class Edge : private totally_ordered<Edge> {
    public:
     /** Construct an invalid Edge. */
-    Edge() {
-        // No code required to create an invalid Edge,
-        // Graph::Edge::Edge() will create an empty Edge
+    Edge() : gp_(nullptr), index_(size_type(-1)), gen_(stale_generation) {
+        // Graph::Edge::Edge() will create an empty, invalid Edge
         
         // See private variables and functions
     }
@@ -538,11 +630,27 @@ class Graph {
 		return (std::less<const Graph*>{}(gp_, e.gp_));
     }
 	  
-	  /** Return the L2 distance between this Edge's two nodes */
+	  /** Return the L2 distance between this Edge's two nodes
+	   *
+	   * Served from the graph's length cache unless a position may have
+	   * been written since the last edge_lengths(); then computed from the
+	   * endpoint positions. Never writes, so concurrent calls are safe.
+	   */
 	  double length() const {
 		  assert(valid());
-		  Point diff = node1().position() - node2().position();
-		  return norm_2(diff);
+		  return gp_->cached_length(gp_->index_edge_map_[index_].index_);
+	  }
+
+	  /** Test whether this edge is still an edge of its graph
+	   * @return true iff the edge's UID slot has the generation it had when
+	   *         this Edge was made; remove_edge(), remove_node() on an
+	   *         endpoint, and clear() bump it
+	   *
+	   * Complexity: O(1), one array load.
+	   */
+	  bool valid() const {
+		  return gp_ != nullptr && index_ < gp_->edge_gen_.size()
+		      && gp_->edge_gen_[index_] == gen_;
 	  }
 
    private:
@@ -560,11 +668,14 @@ class Graph {
       
       // int to store the index of the edge
 	  const size_type index_; //UID
+	  // generation of UID slot index_ when this Edge was made
+	  size_type gen_;
       
       // Valid Edge constructor. Private to fulfill requirement that valid nodes
       // can only be construcrted within the Graph class.
       Edge(const Graph* graph, const Node& a, const Node& b, size_type index)
-      : gp_(const_cast<Graph*>(graph)), index_(index) {
+      : gp_(const_cast<Graph*>(graph)), index_(index),
+        gen_(graph->live_generation(graph->edge_gen_, index)) {
 		  // No self edges
 		  assert(a.index()!=b.index());
 		  
@@ -578,41 +689,6 @@ class Graph {
 		  node_a_index_ = lower;
 		  node_b_index_ = upper;
 	  }
-	  /** Function to test for invariants for Edges
-	   * @brief Tests if this Edge has active index in the correct range, UID in the correct range,
-	   * the edge is in sync for the containers @a index_edge_map_ and @a i2u_edges_, and
-	   * the two nodes this edge connects are in sync in the containers @a index_edge_map_
-	   * and @a i2u_nodes_
-	   * @return true if all invariants are passed, false if not, along with a printout of useful
-	   * diagnostic information for edbugging.
-	   */
-	  bool valid() const {
-		  bool result =
-		  // Edge UID is in range
-		  index_ >=0 && index_ < gp_->index_edge_map_.size()
-		  // Edge Active ID is in range
-		  && gp_->index_edge_map_[index_].index_ < gp_->i2u_edges_.size()
-		  // node UIDs are in correct order
-		  && node_a_index_ < node_b_index_
-		  // Edge UID in sync
-		  && gp_->i2u_edges_[(gp_->index_edge_map_)[index_].index_] == index_
-		   // UID for node a of this edge in sync
-		  && (gp_->i2u_nodes_[(gp_->index_edge_map_)[index_].node_idx_1_]==
-				node_a_index_ || gp_->i2u_nodes_[(gp_->index_edge_map_)[index_].node_idx_2_]==
-				node_a_index_)
-		  // UID for node b of this edge in sync
-		  && (gp_->i2u_nodes_[(gp_->index_edge_map_)[index_].node_idx_1_]==
-				node_b_index_ || gp_->i2u_nodes_[(gp_->index_edge_map_)[index_].node_idx_2_]==
-				node_b_index_);
-		  if (!result) {
-			  auto in = (gp_->index_edge_map_)[index_];
-			  std::cout<<"Validation failed at Edge UID: "<<index_<<std::endl;
-			  std::cout<<"Validation failed at Edge active ID: "<<in.index_<<std::endl;
-			  			  std::cout<<"Validation failed at Node1 active ID: "<<in.node_idx_1_<<std::endl;
-			  			  std::cout<<"Validation failed at Node2 active ID: "<<in.node_idx_2_<<std::endl;
-		  }
-		  return result;
-	  }
   };
 
   /** Return the total number of edges in the graph.
@@ -635,16 +711,8 @@ class Graph {
       // check i is a valid edge index
       assert(i<i2u_edges_.size());
 	  
-	  size_type e_UID = i2u_edges_[i];
-	  
-	  // get both node UIDs.
-	  size_type ia = i2u_nodes_[index_edge_map_[e_UID].node_idx_1_];
-	  size_type ib = i2u_nodes_[index_edge_map_[e_UID].node_idx_2_];
-      
-      // Construct valid Edge. ia and ib do not need to be ordered
-      Edge e = Edge(this, Node(this, ia), Node(this, ib), i);
-          
-    return e;
+	  // Edge stores the UID, not the active index i.
+    return edge_by_uid(i2u_edges_[i]);
   }
     
     /** Helper function to check if two nodes belong to this graph
@@ -677,9 +745,9 @@ class Graph {
 	  size_type b_UID = i2u_nodes_[b.index()];
 
       // map with node a UID as its key
-      std::map<int, int> ma = adj_map_[a_UID];
+      const std::map<int, int>& ma = adj_map_[a_UID];
 	  // map with node b UID as its key
-	  std::map<int, int> mb = adj_map_[b_UID];
+	  const std::map<int, int>& mb = adj_map_[b_UID];
 	  assert((ma.count(b_UID)>0)==(mb.count(a_UID)>0));
       // if and only if map[UID] is not empty, edge exists
       if (ma.count(b_UID)>0||mb.count(b_UID)>0)
@@ -728,35 +796,8 @@ class Graph {
 	  }
 
       else {
-          // update information in Graph class for new edge
-          adj_map_[a_uid][b_uid] = num_edges_;
-		  adj_map_[b_uid][a_uid] = num_edges_;
-
-		  // Declare internal_edge containing the information for
-		  // the Graph class.
-		  internal_edge ie = {
-			.node_idx_1_=a.index(), // active index
-			.node_idx_2_=b.index(), // active index
-			.index_=num_active_edges_, // active index
-			.gp_=this
-		  };
-		  
-		  // add to container of all edges which have ever been
-		  // part of this Graph
-          index_edge_map_.push_back(ie);
-		  
-		  // Add to the set of currently active edges
-		  // i2u_nodes_[num_active_points_] == UID
-		  i2u_edges_.push_back(num_edges_);
-		  
           // set UID of Edge we are returning
-          i = num_edges_;
-		  
-		  num_edges_++;
-		  num_active_edges_++;
-		  
-		  assert(num_edges_==index_edge_map_.size());
-		  assert(num_active_edges_==i2u_edges_.size());
+          i = insert_edge(a.index(), b.index());
       }
   
     return Edge(this, a, b, i);
@@ -792,6 +833,12 @@ size_type remove_edge(const Node& n1, const Node& n2){
 	// Remove from the adjacency map
 	adj_map_[n1_UID].erase(n2_UID);
 	adj_map_[n2_UID].erase(n1_UID);
+	++edge_gen_[e_UID];
+	free_edge_uids_.push_back(e_UID);
+	if (coloring_built_)
+		color_erase(edge_color_, edge_color_pos_, edge_classes_, e_UID);
+	decrement_degree(n1.index());
+	decrement_degree(n2.index());
 	
 	// Remove node from containter of active edges. The edge with the
 	// highest index (==num_active_edges_-1) will now have this node's
@@ -801,6 +848,8 @@ size_type remove_edge(const Node& n1, const Node& n2){
 	size_type swap_uid = i2u_edges_.back();
 	std::swap(i2u_edges_[result], i2u_edges_.back());
 	i2u_edges_.pop_back();
+	lengths_[result] = lengths_.back();
+	lengths_.pop_back();
 	
 	// Update the edge moved into position @result has correct
 	// active / external index. No need to change the active
@@ -826,6 +875,10 @@ size_type remove_edge(const Node& n1, const Node& n2){
 	 */
 size_type remove_edge(const Edge& e) {
 
+	// a removed edge's active index may belong to another edge by now
+	if (!e.valid()) {
+		return 0;
+	}
 	size_type e_UID = i2u_edges_[e.index()];
 	size_type n1_UID = i2u_nodes_[index_edge_map_[e_UID].node_idx_1_];
 	size_type n2_UID = i2u_nodes_[index_edge_map_[e_UID].node_idx_2_];
@@ -833,6 +886,75 @@ size_type remove_edge(const Edge& e) {
 	return remove_edge(Node(this, n1_UID), Node(this, n2_UID));
 	}
 
+	/** Active index reported by remove_nodes() and remove_nodes_if() for
+	 * a node that was removed. */
+	static constexpr size_type removed_index = size_type(-1);
+	
+	/** Remove every node in the range [first, last), and their incident
+	 * edges, in one pass
+	 * @param[in] first, last a range of Node objects (e.g. a node_iterator
+	 * range or a std::vector<Node>); nodes not in this graph are ignored
+	 * @return a vector new_index with one entry per old active index:
+	 * new_index[i] is the active index node i has now, or removed_index
+	 * @post surviving nodes and edges keep their UIDs and their relative
+	 * order of active indices, so their Node and Edge objects stay valid
+	 * @post NodeIterator, EdgeIterator and IncidentIterator objects and
+	 * Spans are invalidated
+	 *
+	 * Removing k nodes with remove_node() swaps and pops each one, and
+	 * each swap renumbers the edges of the node moved in. This compacts
+	 * i2u_nodes_, i2u_edges_ and the arrays indexed by them once instead.
+	 * Callers with their own per-node arrays can permute them once with
+	 * the returned vector.
+	 * Complexity: O(num_nodes() + num_edges()) plus O(log(max degree))
+	 * per removed edge.
+	 */
+	template <typename NodeIter>
+	std::vector<size_type> remove_nodes(NodeIter first, NodeIter last) {
+		std::vector<char> removed(num_active_points_, 0);
+		for (; first != last; ++first) {
+			Node n = *first;
+			if (has_node(n))
+				removed[n.index()] = 1;
+		}
+		return compact_nodes(removed);
+	}
+	
+	/** Remove every node n for which pred(n) is true, and their incident
+	 * edges, in one pass
+	 * @return the old-to-new active index map, as for remove_nodes()
+	 *
+	 * @a pred is called once per node, in active index order, before
+	 * anything is removed.
+	 * Complexity: as for remove_nodes(), plus the predicate calls.
+	 */
+	template <typename Pred>
+	std::vector<size_type> remove_nodes_if(Pred pred) {
+		std::vector<char> removed(num_active_points_, 0);
+		for (size_type i = 0; i < num_active_points_; ++i)
+			removed[i] = pred(node(i)) ? 1 : 0;
+		return compact_nodes(removed);
+	}
+	
+	/** Remove every edge e for which pred(e) is true, in one pass
+	 * @return the number of edges removed
+	 * @post node indices are unchanged; surviving edges keep their UIDs
+	 * and their relative order of active indices
+	 * @post EdgeIterator and IncidentIterator objects are invalidated
+	 *
+	 * @a pred is called once per edge, in active index order, before
+	 * anything is removed.
+	 * Complexity: O(num_edges()) plus O(log(max degree)) per removed
+	 * edge, plus the predicate calls.
+	 */
+	template <typename Pred>
+	size_type remove_edges_if(Pred pred) {
+		std::vector<char> drop(num_active_edges_, 0);
+		for (size_type j = 0; j < num_active_edges_; ++j)
+			drop[j] = pred(edge(j)) ? 1 : 0;
+		return drop_edges(drop);
+	}
+
 
   /** Remove all nodes and edges from this graph.
    * @post num_nodes() == 0 && num_edges() == 0
@@ -842,21 +964,421 @@ size_type remove_edge(const Edge& e) {
   void clear() {
       
       // Set containers to be empty
-      points_.clear();
+      positions_.clear();
+	  values_.clear();
+	  node_index_.clear();
 	  i2u_nodes_.clear();
 	  
       adj_map_.clear();
       index_edge_map_.clear();
 	  i2u_edges_.clear();
 	  
+	  // UIDs restart from 0: free every slot so old Nodes and Edges
+	  // stay invalid when their UIDs are handed out again
+	  for (auto& g : node_gen_) g |= 1;
+	  for (auto& g : edge_gen_) g |= 1;
+	  
+	  degrees_.clear();
+	  degree_count_.assign(1, 0);
+	  lengths_.clear();
+	  moved_.reset(lengths_stale);
+	  
+	  grid_.clear();
+	  grid_dirty_.clear();
+	  moved_.set(grid_stale);
+	  node_moved_.clear();
+	  lengths_moved_.uids.clear();
+	  lengths_moved_.clear();
+	  grid_moved_.uids.clear();
+	  grid_moved_.clear();
+	  drop_coloring();
+	  
       num_points_=0;
       num_edges_=0;
+	  free_node_uids_.clear();
+	  free_edge_uids_.clear();
 	  
 	  num_active_points_=0;
 	  num_active_edges_=0;
       
   }
 
+  /** Renumber node and edge UIDs densely and release unused storage.
+   * @return the number of bytes of array storage released
+   * @post every UID is in use: node(i) has UID i and edge(i) has UID i
+   * @post node and edge indices and all data are unchanged
+   *
+   * remove_node() and remove_edge() put UIDs on free lists for reuse by
+   * the next add_node() and add_edge(), so UID-indexed arrays only grow
+   * to the peak number of nodes and edges. compact() shrinks them, and
+   * every per-node and per-edge array, to the current counts.
+   * Invalidates all outstanding Node and Edge objects (valid() is false
+   * for them) and all iterators and Spans.
+   *
+   * Complexity: O(num_nodes() + num_edges() log(max degree)) plus the
+   * size of the arrays being shrunk.
+   */
+  std::size_t compact() {
+	  std::size_t before = storage_bytes();
+	  edge_lengths();   // the moved lists hold old UIDs
+	  
+	  // new UIDs are active indices
+	  std::vector<size_type> node_uid(num_points_), edge_uid(num_edges_);
+	  for (size_type i = 0; i < num_active_points_; ++i)
+		  node_uid[i2u_nodes_[i]] = i;
+	  for (size_type i = 0; i < num_active_edges_; ++i)
+		  edge_uid[i2u_edges_[i]] = i;
+	  
+	  std::map<int, std::map<int, int>> adj;
+	  for (size_type i = 0; i < num_active_points_; ++i) {
+		  std::map<int, int>& row = adj.emplace_hint(adj.end(), i, std::map<int, int>())->second;
+		  for (const auto& nb : adj_map_[i2u_nodes_[i]])
+			  row.emplace(node_uid[nb.first], edge_uid[nb.second]);
+	  }
+	  adj_map_.swap(adj);
+	  
+	  std::vector<internal_edge> edges;
+	  edges.reserve(num_active_edges_);
+	  for (size_type i = 0; i < num_active_edges_; ++i)
+		  edges.push_back(index_edge_map_[i2u_edges_[i]]);
+	  index_edge_map_.swap(edges);
+	  
+	  for (size_type i = 0; i < num_active_points_; ++i)
+		  node_index_[i] = i2u_nodes_[i] = i;
+	  node_index_.resize(num_active_points_);
+	  for (size_type i = 0; i < num_active_edges_; ++i)
+		  i2u_edges_[i] = i;
+	  
+	  // start each slot past every generation it has had, so no old
+	  // Node or Edge matches it
+	  for (size_type i = 0; i < num_active_points_; ++i)
+		  node_gen_[i] = (node_gen_[i] | 1) + 1;
+	  node_gen_.resize(num_active_points_);
+	  for (size_type i = 0; i < num_active_edges_; ++i)
+		  edge_gen_[i] = (edge_gen_[i] | 1) + 1;
+	  edge_gen_.resize(num_active_edges_);
+	  
+	  num_points_ = num_active_points_;
+	  num_edges_ = num_active_edges_;
+	  free_node_uids_.clear();
+	  free_edge_uids_.clear();
+	  
+	  grid_.clear();
+	  grid_dirty_.clear();
+	  grid_of_.clear();
+	  grid_in_.clear();
+	  moved_.set(grid_stale);
+	  drop_moved(grid_moved_, grid_moved);
+	  node_moved_.resize(num_active_points_);
+	  lengths_moved_.uids.resize(num_active_points_);
+	  grid_moved_.uids.resize(num_active_points_);
+	  drop_coloring();
+	  
+	  positions_.shrink_to_fit();
+	  values_.shrink_to_fit();
+	  node_index_.shrink_to_fit();
+	  i2u_nodes_.shrink_to_fit();
+	  degrees_.shrink_to_fit();
+	  node_gen_.shrink_to_fit();
+	  index_edge_map_.shrink_to_fit();
+	  i2u_edges_.shrink_to_fit();
+	  lengths_.shrink_to_fit();
+	  edge_gen_.shrink_to_fit();
+	  free_node_uids_.shrink_to_fit();
+	  free_edge_uids_.shrink_to_fit();
+	  grid_dirty_.shrink_to_fit();
+	  grid_of_.shrink_to_fit();
+	  grid_in_.shrink_to_fit();
+	  node_moved_.shrink_to_fit();
+	  lengths_moved_.uids.shrink_to_fit();
+	  grid_moved_.uids.shrink_to_fit();
+	  
+	  return before - storage_bytes();
+  }
+
+  //
+  // CONCURRENT CONSTRUCTION
+  //
+
+  /** @class Graph::ConcurrentBuilder
+   * @brief Takes nodes and edges from many threads at once and adds them
+   *        to the graph when sealed.
+   *
+   * add_node() claims the next node index with an atomic counter and writes
+   * into chunked storage without locks. Chunk k holds 1024 * 2^k nodes and
+   * is allocated by whichever thread first needs it, so nothing is moved
+   * or reallocated while other threads write. add_edge() locks one of 64
+   * shards, picked by a hash of the node pair, and records the pair there.
+   *
+   * seal() adds everything to the graph at once: node(i) is the node for
+   * which add_node() returned i, and edges follow shard by shard, in
+   * order of (smaller index, larger index) within a shard. The graph's
+   * arrays are sized once, then filled by several threads, each copying
+   * a range of nodes or a range of shards; the adjacency maps are filled
+   * per node from one merged neighbor list. The result does not depend
+   * on how the calls were interleaved or on the number of threads.
+   *
+   * The graph must not be used otherwise while the builder is open.
+   *
+   * @code
+   * Graph::ConcurrentBuilder builder(graph);
+   * // on every thread:
+   * size_type i = builder.add_node(p), j = builder.add_node(q);
+   * builder.add_edge(i, j);
+   * // after joining the threads:
+   * builder.seal();
+   * @endcode
+   */
+  class ConcurrentBuilder {
+   public:
+	  /** Open a builder that appends to @a graph, which must outlive it.
+	   *  seal() uses @a threads threads including the caller, or one per
+	   *  hardware thread if 0.
+	   */
+	  explicit ConcurrentBuilder(Graph& graph, unsigned threads = 0)
+		  : graph_(&graph), base_(graph.num_nodes()), next_(0), sealed_(false),
+		    threads_(threads ? threads : std::max(1u, std::thread::hardware_concurrency())) {
+		  for (auto& c : chunks_) c.store(nullptr, std::memory_order_relaxed);
+	  }
+
+	  /** Seal the builder if that has not been done yet. */
+	  ~ConcurrentBuilder() {
+		  seal();
+		  for (auto& c : chunks_) delete[] c.load(std::memory_order_relaxed);
+	  }
+
+	  ConcurrentBuilder(const ConcurrentBuilder&) = delete;
+	  ConcurrentBuilder& operator=(const ConcurrentBuilder&) = delete;
+
+	  /** Add a node; safe to call from several threads at once.
+	   * @return the index the node will have in the graph once sealed
+	   *
+	   * Complexity: O(1), plus one chunk allocation per doubling.
+	   */
+	  size_type add_node(const Point& position,
+	                     const node_value_type& value = node_value_type()) {
+		  assert(!sealed_);
+		  size_type k = next_.fetch_add(1, std::memory_order_relaxed);
+		  assert(k < std::numeric_limits<size_type>::max() - base_);
+		  size_type c = chunk_of(k);
+		  node_slot& slot = chunk(c)[k - chunk_start(c)];
+		  slot.position = position;
+		  slot.value = value;
+		  return base_ + k;
+	  }
+
+	  /** Add an edge between the nodes with indices @a a and @a b; safe to
+	   *  call from several threads at once.
+	   * @pre @a a != @a b, and each is a node of the graph or was returned
+	   *      by add_node() on this builder
+	   * @return true if the edge is new to this builder
+	   *
+	   * Edges already in the graph are skipped when sealing.
+	   * Complexity: O(1) expected, under the lock of one shard.
+	   */
+	  bool add_edge(size_type a, size_type b) {
+		  assert(!sealed_ && a != b);
+		  std::uint64_t key = edge_key(a, b);
+		  edge_shard& shard = shards_[(key * 0x9E3779B97F4A7C15ull) >> 58];   // 64 shards
+		  std::lock_guard<std::mutex> lock(shard.mutex);
+		  return shard.keys.insert(key).second;
+	  }
+
+	  /** Return the number of nodes added through this builder so far. */
+	  size_type num_nodes() const {
+		  return next_.load(std::memory_order_relaxed);
+	  }
+
+	  /** Add the collected nodes and edges to the graph.
+	   * @pre no add_node() or add_edge() call is still running, and the
+	   *      graph was not modified since the builder was opened
+	   * @post the builder takes no more nodes or edges
+	   *
+	   * Does nothing if already sealed. New nodes and edges take fresh
+	   * UIDs; UIDs freed before the builder was opened stay on the free
+	   * lists. Invalidates the graph's Spans and iterators like add_node()
+	   * and add_edge(), and drops its cached colorings and spatial grid.
+	   * Complexity: O((N + E log E) / threads + N + E) for N nodes and E
+	   * edges added, plus O(num_nodes()) for the degree histogram.
+	   */
+	  void seal() {
+		  if (sealed_) return;
+		  sealed_ = true;
+		  Graph& g = *graph_;
+		  assert(g.num_nodes() == base_);
+
+		  // Size the per-node arrays, then copy the chunks into them
+		  size_type n = next_.load(std::memory_order_acquire);
+		  size_type total = base_ + n, uid0 = g.num_points_;
+		  g.positions_.resize(total);
+		  g.values_.resize(total);
+		  g.degrees_.resize(total, 0);
+		  g.i2u_nodes_.resize(total);
+		  g.node_index_.resize(uid0 + n);
+		  g.node_gen_.resize(uid0 + n, 0);
+		  g.node_moved_.resize(uid0 + n);
+		  g.lengths_moved_.uids.resize(uid0 + n);
+		  g.grid_moved_.uids.resize(uid0 + n);
+		  parallel(n, [this, &g, uid0](size_type begin, size_type end) {
+			  for (size_type k = begin; k < end; ++k) {
+				  size_type c = chunk_of(k);
+				  const node_slot& slot = chunks_[c].load(std::memory_order_relaxed)[k - chunk_start(c)];
+				  g.positions_[base_ + k] = slot.position;
+				  g.values_[base_ + k] = slot.value;
+				  g.i2u_nodes_[base_ + k] = uid0 + k;
+				  g.node_index_[uid0 + k] = base_ + k;
+				  revive(g.node_gen_, uid0 + k);   // slots left freed by clear()
+			  }
+		  });
+		  for (size_type k = 0; k < n; ++k)   // new UIDs exceed every key
+			  g.adj_map_.emplace_hint(g.adj_map_.end(), uid0 + k, std::map<int, int>());
+
+		  // Sort each shard and drop the edges the graph already has
+		  std::vector<std::vector<std::uint64_t>> keys(num_shards);
+		  parallel(num_shards, [this, &g, &keys, total](size_type begin, size_type end) {
+			  for (size_type s = begin; s < end; ++s) {
+				  std::vector<std::uint64_t>& v = keys[s];
+				  for (std::uint64_t key : shards_[s].keys) {
+					  size_type a = size_type(key >> 32), b = size_type(key);
+					  assert(b < total);
+					  if (b >= base_ || g.adj_map_.at(g.i2u_nodes_[a]).count(g.i2u_nodes_[b]) == 0)
+						  v.push_back(key);
+				  }
+				  std::unordered_set<std::uint64_t>().swap(shards_[s].keys);
+				  std::sort(v.begin(), v.end());
+			  }
+		  });
+		  std::vector<size_type> offset(num_shards + 1, 0);
+		  for (size_type s = 0; s < num_shards; ++s)
+			  offset[s + 1] = offset[s] + keys[s].size();
+		  size_type m = offset[num_shards];
+
+		  // Size the per-edge arrays and fill them shard by shard
+		  size_type e_uid0 = g.num_edges_, e_idx0 = g.num_active_edges_;
+		  g.index_edge_map_.resize(e_uid0 + m);
+		  g.edge_gen_.resize(e_uid0 + m, 0);
+		  g.i2u_edges_.resize(e_idx0 + m);
+		  g.lengths_.resize(e_idx0 + m);
+		  parallel(num_shards, [&](size_type begin, size_type end) {
+			  for (size_type s = begin; s < end; ++s)
+				  for (size_type j = 0; j < keys[s].size(); ++j) {
+					  size_type a = size_type(keys[s][j] >> 32), b = size_type(keys[s][j]);
+					  size_type k = offset[s] + j;
+					  g.index_edge_map_[e_uid0 + k] = internal_edge{a, b, e_idx0 + k, &g, edge_value_type()};
+					  g.i2u_edges_[e_idx0 + k] = e_uid0 + k;
+					  revive(g.edge_gen_, e_uid0 + k);
+					  g.lengths_[e_idx0 + k] = norm_2(g.positions_[a] - g.positions_[b]);
+				  }
+		  });
+
+		  // Merge the new neighbors of every node into one list, by node
+		  std::vector<size_type> first(total + 1, 0);
+		  for (const auto& v : keys)
+			  for (std::uint64_t key : v) {
+				  ++first[(key >> 32) + 1];
+				  ++first[size_type(key) + 1];
+			  }
+		  for (size_type i = 0; i < total; ++i)
+			  first[i + 1] += first[i];
+		  std::vector<std::pair<int, int>> nbrs(first[total]);
+		  std::vector<size_type> fill(first.begin(), first.end() - 1);
+		  for (size_type s = 0; s < num_shards; ++s)
+			  for (size_type j = 0; j < keys[s].size(); ++j) {
+				  size_type a = size_type(keys[s][j] >> 32), b = size_type(keys[s][j]);
+				  int uid = int(e_uid0 + offset[s] + j);
+				  nbrs[fill[a]++] = std::make_pair(int(g.i2u_nodes_[b]), uid);
+				  nbrs[fill[b]++] = std::make_pair(int(g.i2u_nodes_[a]), uid);
+			  }
+		  std::vector<size_type>().swap(fill);
+		  std::vector<std::vector<std::uint64_t>>().swap(keys);
+
+		  // Fill each node's adjacency map in neighbor order
+		  std::vector<std::map<int, int>*> row(total);
+		  for (auto& r : g.adj_map_)
+			  row[g.node_index_[r.first]] = &r.second;
+		  parallel(total, [&](size_type begin, size_type end) {
+			  for (size_type i = begin; i < end; ++i) {
+				  if (first[i] == first[i + 1]) continue;
+				  std::sort(nbrs.begin() + first[i], nbrs.begin() + first[i + 1]);
+				  for (size_type k = first[i]; k < first[i + 1]; ++k)
+					  row[i]->emplace_hint(row[i]->end(), nbrs[k].first, nbrs[k].second);
+				  g.degrees_[i] += first[i + 1] - first[i];
+			  }
+		  });
+
+		  g.degree_count_.assign(1, 0);
+		  for (size_type d : g.degrees_) {
+			  if (d >= g.degree_count_.size()) g.degree_count_.resize(d + 1, 0);
+			  ++g.degree_count_[d];
+		  }
+		  g.num_points_ = uid0 + n;
+		  g.num_active_points_ = total;
+		  g.num_edges_ = e_uid0 + m;
+		  g.num_active_edges_ = e_idx0 + m;
+		  g.moved_.set(grid_stale);
+		  g.drop_coloring();
+	  }
+
+   private:
+	  struct node_slot {
+		  Point position;
+		  node_value_type value;
+	  };
+	  struct alignas(64) edge_shard {
+		  std::mutex mutex;
+		  std::unordered_set<std::uint64_t> keys;   // (min << 32) | max
+	  };
+	  static constexpr size_type first_chunk = 1024;
+	  static constexpr int max_chunks = 23;   // enough for 2^32 nodes
+	  static constexpr size_type num_shards = 64;
+
+	  Graph* graph_;
+	  size_type base_;
+	  std::atomic<size_type> next_;
+	  bool sealed_;
+	  unsigned threads_;
+	  std::atomic<node_slot*> chunks_[max_chunks];
+	  edge_shard shards_[num_shards];
+
+	  static std::uint64_t edge_key(size_type a, size_type b) {
+		  if (b < a) std::swap(a, b);
+		  return (std::uint64_t(a) << 32) | b;
+	  }
+	  /** Return the first builder node index stored in chunk @a c. */
+	  static std::uint64_t chunk_start(size_type c) {
+		  return first_chunk * ((std::uint64_t(1) << c) - 1);
+	  }
+	  /** Return the chunk that stores builder node index @a k. */
+	  static size_type chunk_of(size_type k) {
+		  std::uint64_t q = k / first_chunk + 1;
+		  size_type c = 0;
+		  while (q >>= 1) ++c;
+		  return c;
+	  }
+	  /** Run @a f(begin, end) on up to threads_ contiguous blocks of
+	   *  [0, @a n), one of them on the calling thread.
+	   */
+	  template <typename F>
+	  void parallel(size_type n, F f) const {
+		  unsigned t = unsigned(std::min<std::uint64_t>(threads_, std::max<size_type>(n, 1)));
+		  auto cut = [n, t](unsigned k) { return size_type(std::uint64_t(n) * k / t); };
+		  std::vector<std::thread> pool;
+		  for (unsigned k = 1; k < t; ++k)
+			  pool.emplace_back(f, cut(k), cut(k + 1));
+		  f(size_type(0), cut(1));
+		  for (auto& th : pool) th.join();
+	  }
+	  /** Return chunk @a c, allocating it if no thread has yet. */
+	  node_slot* chunk(size_type c) {
+		  node_slot* p = chunks_[c].load(std::memory_order_acquire);
+		  if (p) return p;
+		  std::unique_ptr<node_slot[]> fresh(new node_slot[first_chunk << c]);
+		  if (chunks_[c].compare_exchange_strong(p, fresh.get(), std::memory_order_acq_rel))
+			  return fresh.release();
+		  return p;   // another thread won; use its chunk
+	  }
+  };
+
   //
   // Node Iterator
   //
@@ -1099,15 +1621,905 @@ size_type remove_edge(const Edge& e) {
 		return e_it;
 	}
 
+	/** Return a writable view of all node positions
+	 * @post result[n.index()] is n.position() for every node n of this graph
+	 * @post all cached edge lengths are stale
+	 *
+	 * Positions are stored contiguously in active index order, so bulk
+	 * updates can loop over this view instead of going through Node proxies.
+	 * Call positions_changed() if the view is written after edge lengths
+	 * have been read again.
+	 * Complexity: O(1).
+	 */
+	Span<Point> positions() {
+		positions_changed();
+		return Span<Point>(positions_.data(), num_active_points_);
+	}
+
+	/** Return a read-only view of all node positions */
+	Span<const Point> positions() const {
+		return Span<const Point>(positions_.data(), num_active_points_);
+	}
+
+	/** Return a writable view of all node values
+	 * @post result[n.index()] is n.value() for every node n of this graph
+	 *
+	 * Complexity: O(1).
+	 */
+	Span<node_value_type> values() {
+		return Span<node_value_type>(values_.data(), num_active_points_);
+	}
+
+	/** Return a read-only view of all node values */
+	Span<const node_value_type> values() const {
+		return Span<const node_value_type>(values_.data(), num_active_points_);
+	}
+
+	/** Renumber the nodes to improve memory locality
+	 * @param[in] strategy How to compute the new order
+	 * @return perm such that the node with old index i has new index perm[i]
+	 * @post node(perm[i]) is the node formerly returned by node(i)
+	 * @post node(i) has UID i and edge(i) has UID i, as after compact()
+	 *
+	 * Node data are permuted, so neighbors in the mesh end up close
+	 * together in positions() and values(). The UIDs and the adjacency
+	 * maps keyed by them are then renumbered by compact(), so incident
+	 * edges are also visited in the new order; without that step a
+	 * neighbor sweep would still jump around memory in the old order.
+	 * Edge indices are unchanged. Like compact(), this invalidates all
+	 * outstanding Node and Edge objects, iterators and Spans.
+	 *
+	 * Complexity: O(num_nodes() log num_nodes() + num_edges() log(max degree)).
+	 */
+	std::vector<size_type> reorder(reorder_strategy strategy) {
+		std::vector<size_type> order = (strategy == reorder_strategy::morton)
+			? morton_order() : rcm_order();
+		std::vector<size_type> perm(num_active_points_);
+		for (size_type i = 0; i < num_active_points_; ++i)
+			perm[order[i]] = i;
+		
+		std::vector<Point> positions(num_active_points_);
+		std::vector<node_value_type> values(num_active_points_);
+		std::vector<size_type> degrees(num_active_points_);
+		std::vector<size_type> i2u(num_active_points_);
+		for (size_type i = 0; i < num_active_points_; ++i) {
+			positions[perm[i]] = positions_[i];
+			values[perm[i]] = values_[i];
+			degrees[perm[i]] = degrees_[i];
+			i2u[perm[i]] = i2u_nodes_[i];
+			node_index_[i2u_nodes_[i]] = perm[i];
+		}
+		positions_.swap(positions);
+		values_.swap(values);
+		degrees_.swap(degrees);
+		i2u_nodes_.swap(i2u);
+		
+		// Edges refer to their nodes by active index
+		for (size_type e_UID : i2u_edges_) {
+			index_edge_map_[e_UID].node_idx_1_ = perm[index_edge_map_[e_UID].node_idx_1_];
+			index_edge_map_[e_UID].node_idx_2_ = perm[index_edge_map_[e_UID].node_idx_2_];
+		}
+		compact();
+		return perm;
+	}
+
+	/** Return the largest degree of any node, or 0 for an empty graph.
+	 *  Complexity: O(1).
+	 */
+	size_type max_degree() const {
+		return degree_count_.size() - 1;
+	}
+
+	/** Return the degree histogram of the graph
+	 * @return vector h with h[d] the number of nodes of degree d, for
+	 *         0 <= d <= max_degree()
+	 *
+	 * Maintained by add_node, add_edge, remove_edge and remove_node.
+	 * Complexity: O(1).
+	 */
+	const std::vector<size_type>& degree_histogram() const {
+		return degree_count_;
+	}
+
+	/** Return the number of edge colors.
+	 *
+	 * Edges are colored greedily so that edges sharing an endpoint differ
+	 * in color, which takes at most 2 * max_degree() - 1 colors. The
+	 * coloring is computed by the first color query and then kept up to
+	 * date by add_edge (which colors the new edge) and remove_edge, at
+	 * O(degree) per call; compact() and clear() drop it.
+	 * Complexity: O(num_edges() * max_degree()) for the first query,
+	 * else O(1).
+	 *
+	 * @code
+	 * // accumulate spring forces without atomics
+	 * for (size_type c = 0; c < g.num_edge_colors(); ++c) {
+	 *   auto edges = g.edge_color_class(c);
+	 *   #pragma omp parallel for
+	 *   for (size_type k = 0; k < edges.size(); ++k) apply(edges[k]);
+	 * }
+	 * @endcode
+	 */
+	size_type num_edge_colors() const {
+		build_coloring();
+		return edge_classes_.size();
+	}
+
+	/** Return the edges of color @a c; no two of them share a node.
+	 * @pre @a c < num_edge_colors()
+	 */
+	ColorClass<Edge> edge_color_class(size_type c) const {
+		build_coloring();
+		assert(c < edge_classes_.size());
+		return ColorClass<Edge>(this, edge_classes_[c]);
+	}
+
+	/** Return the color of edge @a e, in [0, num_edge_colors()). */
+	size_type edge_color(const Edge& e) const {
+		assert(e.valid());
+		build_coloring();
+		return edge_color_[e.index_];
+	}
+
+	/** Return the number of node colors.
+	 *
+	 * Nodes are colored greedily so that adjacent nodes differ in color,
+	 * which takes at most max_degree() + 1 colors. Maintained like the
+	 * edge coloring: add_edge recolors one endpoint if both share a color,
+	 * add_node and remove_node update the classes.
+	 */
+	size_type num_node_colors() const {
+		build_coloring();
+		return node_classes_.size();
+	}
+
+	/** Return the nodes of color @a c; no two of them are adjacent.
+	 * @pre @a c < num_node_colors()
+	 */
+	ColorClass<Node> node_color_class(size_type c) const {
+		build_coloring();
+		assert(c < node_classes_.size());
+		return ColorClass<Node>(this, node_classes_[c]);
+	}
+
+	/** Return the color of node @a n, in [0, num_node_colors()). */
+	size_type node_color(const Node& n) const {
+		assert(n.valid());
+		build_coloring();
+		return node_color_[n.index_];
+	}
+
+	/** Mark every cached edge length and the spatial grid as stale
+	 * @post the next length read of any edge recomputes it, and the next
+	 *       spatial query rebuilds the grid
+	 *
+	 * For bulk position updates that bypass Node::position(). Only sets
+	 * atomic flags, so it may be called from parallel loops.
+	 * Complexity: O(1).
+	 */
+	void positions_changed() {
+		moved_.set(lengths_stale | grid_stale);
+	}
+
+	/** Return a read-only view of all edge lengths
+	 * @post result[e.index()] == e.length() for every edge e of this graph
+	 *
+	 * This is the pass that refreshes the length cache: the edges incident
+	 * to nodes marked as moved since the last call are recomputed, or
+	 * every edge after positions_changed(). Spring and shortest-path code
+	 * can then read lengths from one contiguous array, and Edge::length()
+	 * reads the cache again.
+	 * Complexity: O(sum of the degrees of the moved nodes), O(num_edges())
+	 * after positions_changed().
+	 */
+	Span<const double> edge_lengths() {
+		if (moved_.get() & lengths_stale) {
+			for (size_type i = 0; i < num_active_edges_; ++i)
+				lengths_[i] = edge_length(i);
+			moved_.reset(lengths_stale);
+		}
+		else {
+			for (size_type k = 0; k < lengths_moved_.size(); ++k) {
+				size_type uid = lengths_moved_.uids[k];
+				if (!node_live(uid)) continue;
+				for (const auto& nb : adj_map_.at(uid)) {
+					size_type i = index_edge_map_[nb.second].index_;
+					lengths_[i] = edge_length(i);
+				}
+			}
+		}
+		drop_moved(lengths_moved_, lengths_moved);
+		return Span<const double>(lengths_.data(), num_active_edges_);
+	}
+
+	/** Return the node closest to @a p
+	 * @pre num_nodes() > 0
+	 * @post norm(result.position() - p) <= norm(n.position() - p) for
+	 *       every node n of this graph
+	 *
+	 * Searches the spatial grid in growing shells of cells around @a p.
+	 * The first spatial query after nodes were added or moved brings the
+	 * grid up to date, re-filing only those nodes; later ones only read
+	 * it. So spatial queries may run concurrently with each other once one
+	 * has run since the last such change, and never concurrently with
+	 * position writes, which include any call of the mutable
+	 * Node::position().
+	 * Complexity: O(1) expected for points inside the mesh, plus O(1) per
+	 * node moved since the last query; never worse than a scan of all
+	 * nodes.
+	 */
+	Node nearest_node(const Point& p) const {
+		assert(num_active_points_ > 0);
+		grid_sync();
+		grid_key c = grid_cell(p);
+		
+		// Shells beyond the occupied extent are empty
+		long long last = 0;
+		for (int k = 0; k < 3; ++k)
+			last = std::max({last, c[k] - grid_lo_[k], grid_hi_[k] - c[k]});
+		
+		size_type best = 0;
+		double best_d2 = INFINITY;
+		std::size_t visited = 0;
+		for (long long r = 0; r <= last; ++r) {
+			// every node in shell r + 1 or further is at least r * h away
+			double bound = r > 0 ? (r - 1) * cell_size_ : 0.0;
+			if (best_d2 < INFINITY && bound * bound >= best_d2)
+				break;
+			// a far-away query would touch more cells than nodes: scan instead
+			visited += (r == 0) ? 1 : std::size_t(24 * r * r + 2);
+			if (visited > num_active_points_) {
+				for (size_type i = 0; i < num_active_points_; ++i) {
+					double d2 = normSq(positions_[i] - p);
+					if (d2 < best_d2) { best_d2 = d2; best = i2u_nodes_[i]; }
+				}
+				break;
+			}
+			// visit only the surface of the shell: full z rows on its x and y
+			// faces, the two z caps elsewhere
+			for (long long x = c[0] - r; x <= c[0] + r; ++x)
+				for (long long y = c[1] - r; y <= c[1] + r; ++y) {
+					bool face = (x == c[0] - r || x == c[0] + r || y == c[1] - r || y == c[1] + r);
+					long long step = (face || r == 0) ? 1 : 2 * r;
+					for (long long z = c[2] - r; z <= c[2] + r; z += step) {
+						auto cell = grid_.find(grid_key{{x, y, z}});
+						if (cell == grid_.end()) continue;
+						for (size_type uid : cell->second) {
+							double d2 = normSq(positions_[node_index_[uid]] - p);
+							if (d2 < best_d2) { best_d2 = d2; best = uid; }
+						}
+					}
+				}
+		}
+		return Node(this, best);
+	}
+
+	/** Return all nodes inside the axis-aligned box [@a lo, @a hi]
+	 * @post n.position() lies in the box, bounds included, for every n in
+	 *       result, and every such node of this graph is in result
+	 *
+	 * The order of the result is unspecified.
+	 * Complexity: O(cells overlapping the box + size of result) expected.
+	 */
+	std::vector<Node> nodes_in_box(const Point& lo, const Point& hi) const {
+		return grid_collect(lo, hi, [&lo, &hi](const Point& q) {
+			return lo[0] <= q[0] && q[0] <= hi[0] && lo[1] <= q[1] && q[1] <= hi[1]
+				&& lo[2] <= q[2] && q[2] <= hi[2];
+		});
+	}
+
+	/** Return all nodes within distance @a r of @a p
+	 * @pre r >= 0
+	 * @post norm(n.position() - p) <= r for every n in result, and every
+	 *       such node of this graph is in result
+	 *
+	 * Complexity: as nodes_in_box() for the box bounding the ball.
+	 */
+	std::vector<Node> nodes_within(const Point& p, double r) const {
+		assert(r >= 0);
+		return grid_collect(p - Point(r, r, r), p + Point(r, r, r), [&p, r](const Point& q) {
+			return normSq(q - p) <= r * r;
+		});
+	}
+
  private:
 	
-	// struct containing any information we need to keep about the nodes
-	struct internal_node {
-		Point p_;
-		size_type index_; // active index
-		Graph* gp_;
-		node_value_type val_;
+	// Node and Edge proxies carry the generation of their UID slot. A
+	// slot's generation is even while it is live and odd while it is
+	// free; removal frees it and reuse revives it, so a proxy matches its
+	// slot only until the element it was made for is removed.
+	static constexpr size_type stale_generation = size_type(-1);
+	
+	/** Return the generation of live slot @a uid, or stale_generation */
+	static size_type live_generation(const std::vector<size_type>& gens, size_type uid) {
+		return uid < gens.size() && gens[uid] % 2 == 0 ? gens[uid] : stale_generation;
+	}
+	
+	/** Return the Node with UID @a uid */
+	Node by_uid(size_type uid, Node*) const {
+		return Node(this, uid);
+	}
+	
+	/** Return the Edge with UID @a uid */
+	Edge by_uid(size_type uid, Edge*) const {
+		return edge_by_uid(uid);
+	}
+	
+	/** Return the Edge with UID @a uid */
+	Edge edge_by_uid(size_type uid) const {
+		// get both node UIDs; they do not need to be ordered
+		size_type ia = i2u_nodes_[index_edge_map_[uid].node_idx_1_];
+		size_type ib = i2u_nodes_[index_edge_map_[uid].node_idx_2_];
+		return Edge(this, Node(this, ia), Node(this, ib), uid);
+	}
+	
+	/** Put @a uid into color class @a c */
+	static void color_insert(std::vector<size_type>& color, std::vector<size_type>& pos,
+	                         std::vector<std::vector<size_type>>& classes,
+	                         size_type uid, size_type c) {
+		if (uid >= color.size()) {
+			color.resize(uid + 1, size_type(no_color));
+			pos.resize(uid + 1);
+		}
+		if (c == classes.size()) classes.emplace_back();
+		color[uid] = c;
+		pos[uid] = classes[c].size();
+		classes[c].push_back(uid);
+	}
+	
+	/** Take @a uid out of its color class, dropping empty top classes */
+	static void color_erase(std::vector<size_type>& color, std::vector<size_type>& pos,
+	                        std::vector<std::vector<size_type>>& classes, size_type uid) {
+		std::vector<size_type>& cls = classes[color[uid]];
+		size_type moved = cls.back();
+		cls[pos[uid]] = moved;
+		pos[moved] = pos[uid];
+		cls.pop_back();
+		color[uid] = no_color;
+		while (!classes.empty() && classes.back().empty())
+			classes.pop_back();
+	}
+	
+	/** Return the smallest color not in @a used, using @a mark as scratch */
+	static size_type first_free(const std::vector<size_type>& used, std::vector<char>& mark) {
+		mark.assign(used.size() + 1, 0);
+		for (size_type c : used)
+			if (c < mark.size()) mark[c] = 1;
+		size_type c = 0;
+		while (mark[c]) ++c;
+		return c;
+	}
+	
+	/** Return the smallest color not used by an edge at node @a uid or
+	 *  @a other_uid, appending to the scratch list @a used
+	 */
+	size_type free_edge_color(size_type uid, size_type other_uid,
+	                          std::vector<size_type>& used, std::vector<char>& mark) const {
+		used.clear();
+		for (size_type n : {uid, other_uid})
+			for (const auto& nb : adj_map_.at(n))
+				if (size_type(nb.second) < edge_color_.size() && edge_color_[nb.second] != no_color)
+					used.push_back(edge_color_[nb.second]);
+		return first_free(used, mark);
+	}
+	
+	/** Return the smallest color not used by a neighbor of node @a uid */
+	size_type free_node_color(size_type uid, std::vector<size_type>& used,
+	                          std::vector<char>& mark) const {
+		used.clear();
+		for (const auto& nb : adj_map_.at(uid))
+			if (size_type(nb.first) < node_color_.size() && node_color_[nb.first] != no_color)
+				used.push_back(node_color_[nb.first]);
+		return first_free(used, mark);
+	}
+	
+	/** Color edge @a uid, just added between nodes @a a_uid and @a b_uid,
+	 *  and recolor @a b_uid if it now clashes with @a a_uid
+	 */
+	void color_new_edge(size_type uid, size_type a_uid, size_type b_uid) {
+		std::vector<size_type> used;
+		std::vector<char> mark;
+		if (uid < edge_color_.size()) edge_color_[uid] = no_color;
+		color_insert(edge_color_, edge_color_pos_, edge_classes_, uid,
+		             free_edge_color(a_uid, b_uid, used, mark));
+		if (node_color_[a_uid] == node_color_[b_uid]) {
+			color_erase(node_color_, node_color_pos_, node_classes_, b_uid);
+			color_insert(node_color_, node_color_pos_, node_classes_, b_uid,
+			             free_node_color(b_uid, used, mark));
+		}
+	}
+	
+	/** Compute the greedy node and edge colorings if they are not cached */
+	void build_coloring() const {
+		if (coloring_built_) return;
+		std::vector<size_type> used;
+		std::vector<char> mark;
+		node_color_.assign(num_points_, size_type(no_color));
+		node_color_pos_.assign(num_points_, 0);
+		node_classes_.clear();
+		for (size_type i = 0; i < num_active_points_; ++i)
+			color_insert(node_color_, node_color_pos_, node_classes_, i2u_nodes_[i],
+			             free_node_color(i2u_nodes_[i], used, mark));
+		edge_color_.assign(num_edges_, size_type(no_color));
+		edge_color_pos_.assign(num_edges_, 0);
+		edge_classes_.clear();
+		for (size_type i = 0; i < num_active_edges_; ++i) {
+			const internal_edge& ie = index_edge_map_[i2u_edges_[i]];
+			color_insert(edge_color_, edge_color_pos_, edge_classes_, i2u_edges_[i],
+			             free_edge_color(i2u_nodes_[ie.node_idx_1_], i2u_nodes_[ie.node_idx_2_], used, mark));
+		}
+		coloring_built_ = true;
+	}
+	
+	/** Forget the cached colorings */
+	void drop_coloring() {
+		coloring_built_ = false;
+		std::vector<std::vector<size_type>>().swap(node_classes_);
+		std::vector<std::vector<size_type>>().swap(edge_classes_);
+		std::vector<size_type>().swap(node_color_);
+		std::vector<size_type>().swap(node_color_pos_);
+		std::vector<size_type>().swap(edge_color_);
+		std::vector<size_type>().swap(edge_color_pos_);
+	}
+	
+	/** Take a UID from the free list @a free, or else the new UID @a count,
+	 *  which is then incremented.
+	 */
+	static size_type claim_uid(std::vector<size_type>& free, size_type& count) {
+		if (free.empty())
+			return count++;
+		size_type uid = free.back();
+		free.pop_back();
+		return uid;
+	}
+	
+	/** Return the bytes held by the graph's arrays, as reported by compact() */
+	std::size_t storage_bytes() const {
+		auto bytes = [](const auto& v) { return v.capacity() * sizeof(v[0]); };
+		return bytes(positions_) + bytes(values_) + bytes(node_index_)
+			+ bytes(i2u_nodes_) + bytes(degrees_)
+			+ bytes(node_gen_) + bytes(index_edge_map_) + bytes(i2u_edges_)
+			+ bytes(lengths_) + bytes(edge_gen_)
+			+ bytes(free_node_uids_) + bytes(free_edge_uids_)
+			+ bytes(grid_dirty_) + bytes(grid_of_) + bytes(grid_in_)
+			+ bytes(node_moved_) + bytes(lengths_moved_.uids) + bytes(grid_moved_.uids);
+	}
+	
+	/** Mark slot @a uid of @a gens live, adding it if it is new */
+	static void revive(std::vector<size_type>& gens, size_type uid) {
+		if (uid == gens.size())
+			gens.push_back(0);
+		else if (gens[uid] % 2 == 1)
+			++gens[uid];
+	}
+	
+	/** Record a new edge between the nodes with active indices @a a and
+	 *  @a b, which must not already be adjacent, and return its UID.
+	 */
+	size_type insert_edge(size_type a, size_type b) {
+		size_type a_uid = i2u_nodes_[a];
+		size_type b_uid = i2u_nodes_[b];
+		size_type uid = claim_uid(free_edge_uids_, num_edges_);
+		
+		// update information in Graph class for new edge
+		adj_map_[a_uid][b_uid] = uid;
+		adj_map_[b_uid][a_uid] = uid;
+		
+		// Declare internal_edge containing the information for
+		// the Graph class.
+		internal_edge ie = {
+			.node_idx_1_=a, // active index
+			.node_idx_2_=b, // active index
+			.index_=num_active_edges_, // active index
+			.gp_=this
+		};
+		
+		// add to container of all edges, or reuse the freed slot
+		if (uid == index_edge_map_.size())
+			index_edge_map_.push_back(ie);
+		else
+			index_edge_map_[uid] = ie;
+		
+		lengths_.push_back(norm_2(positions_[a] - positions_[b]));
+		
+		// Add to the set of currently active edges
+		i2u_edges_.push_back(uid);
+		revive(edge_gen_, uid);
+		
+		num_active_edges_++;
+		
+		increment_degree(a);
+		increment_degree(b);
+		if (coloring_built_)
+			color_new_edge(uid, a_uid, b_uid);
+		
+		assert(num_edges_==index_edge_map_.size());
+		assert(num_active_edges_==i2u_edges_.size());
+		return uid;
+	}
+	
+	/** Add one to the degree of the node with active index @a i */
+	void increment_degree(size_type i) {
+		size_type d = degrees_[i]++;
+		--degree_count_[d];
+		if (d + 1 == degree_count_.size()) degree_count_.push_back(0);
+		++degree_count_[d + 1];
+	}
+	
+	/** Subtract one from the degree of the node with active index @a i,
+	 *  dropping empty top entries of the histogram
+	 */
+	void decrement_degree(size_type i) {
+		size_type d = degrees_[i]--;
+		--degree_count_[d];
+		++degree_count_[d - 1];
+		while (degree_count_.size() > 1 && degree_count_.back() == 0)
+			degree_count_.pop_back();
+	}
+	
+	/** Remove the edges whose active index j has @a drop[j] set, keeping
+	 * the others in order; shared by remove_edges_if() and compact_nodes()
+	 * @return the number of edges removed
+	 */
+	size_type drop_edges(const std::vector<char>& drop) {
+		size_type kept = 0;
+		for (size_type j = 0; j < num_active_edges_; ++j) {
+			size_type uid = i2u_edges_[j];
+			internal_edge& ie = index_edge_map_[uid];
+			if (drop[j]) {
+				size_type a_uid = i2u_nodes_[ie.node_idx_1_];
+				size_type b_uid = i2u_nodes_[ie.node_idx_2_];
+				adj_map_[a_uid].erase(b_uid);
+				adj_map_[b_uid].erase(a_uid);
+				++edge_gen_[uid];
+				free_edge_uids_.push_back(uid);
+				if (coloring_built_)
+					color_erase(edge_color_, edge_color_pos_, edge_classes_, uid);
+				decrement_degree(ie.node_idx_1_);
+				decrement_degree(ie.node_idx_2_);
+				continue;
+			}
+			ie.index_ = kept;
+			i2u_edges_[kept] = uid;
+			lengths_[kept] = lengths_[j];
+			++kept;
+		}
+		size_type dropped = num_active_edges_ - kept;
+		i2u_edges_.resize(kept);
+		lengths_.resize(kept);
+		num_active_edges_ = kept;
+		return dropped;
+	}
+	
+	/** Remove the nodes whose active index i has @a removed[i] set, and
+	 * their edges, keeping the other nodes in order
+	 * @return the old-to-new active index map, see remove_nodes()
+	 */
+	std::vector<size_type> compact_nodes(const std::vector<char>& removed) {
+		// isolate the removed nodes first
+		std::vector<char> drop(num_active_edges_, 0);
+		for (size_type j = 0; j < num_active_edges_; ++j) {
+			const internal_edge& ie = index_edge_map_[i2u_edges_[j]];
+			drop[j] = removed[ie.node_idx_1_] | removed[ie.node_idx_2_];
+		}
+		drop_edges(drop);
+		
+		std::vector<size_type> new_index(num_active_points_, size_type(removed_index));
+		size_type kept = 0;
+		for (size_type i = 0; i < num_active_points_; ++i) {
+			size_type uid = i2u_nodes_[i];
+			if (removed[i]) {
+				assert(adj_map_[uid].empty());
+				adj_map_.erase(uid);
+				grid_erase(uid);
+				if (coloring_built_)
+					color_erase(node_color_, node_color_pos_, node_classes_, uid);
+				++node_gen_[uid];
+				free_node_uids_.push_back(uid);
+				--degree_count_[0];
+				continue;
+			}
+			new_index[i] = kept;
+			node_index_[uid] = kept;
+			i2u_nodes_[kept] = uid;
+			positions_[kept] = positions_[i];
+			values_[kept] = values_[i];
+			degrees_[kept] = degrees_[i];
+			++kept;
+		}
+		positions_.erase(positions_.begin() + kept, positions_.end());
+		values_.erase(values_.begin() + kept, values_.end());
+		degrees_.resize(kept);
+		i2u_nodes_.resize(kept);
+		num_active_points_ = kept;
+		
+		// the surviving edges' endpoints moved with their nodes
+		for (size_type j = 0; j < num_active_edges_; ++j) {
+			internal_edge& ie = index_edge_map_[i2u_edges_[j]];
+			ie.node_idx_1_ = new_index[ie.node_idx_1_];
+			ie.node_idx_2_ = new_index[ie.node_idx_2_];
+		}
+		return new_index;
+	}
+	
+	/** Return active node indices in reverse Cuthill-McKee order. Each
+	 *  connected component is searched breadth-first from a node of minimum
+	 *  degree, visiting neighbors by increasing degree.
+	 */
+	std::vector<size_type> rcm_order() const {
+		const std::vector<size_type>& degree = degrees_;
+		std::vector<size_type> starts(num_active_points_);
+		for (size_type i = 0; i < num_active_points_; ++i)
+			starts[i] = i;
+		std::stable_sort(starts.begin(), starts.end(), [&degree](size_type a, size_type b) {
+			return degree[a] < degree[b];
+		});
+		
+		std::vector<size_type> order;
+		order.reserve(num_active_points_);
+		std::vector<char> seen(num_active_points_, 0);
+		for (size_type s : starts) {
+			if (seen[s]) continue;
+			seen[s] = 1;
+			order.push_back(s);
+			// order itself is the BFS queue
+			for (std::size_t head = order.size() - 1; head < order.size(); ++head) {
+				std::size_t first = order.size();
+				for (auto& nb : adj_map_.at(i2u_nodes_[order[head]])) {
+					size_type j = node_index_[nb.first];
+					if (!seen[j]) { seen[j] = 1; order.push_back(j); }
+				}
+				std::stable_sort(order.begin() + first, order.end(), [&degree](size_type a, size_type b) {
+					return degree[a] < degree[b];
+				});
+			}
+		}
+		std::reverse(order.begin(), order.end());
+		return order;
+	}
+	
+	/** Return active node indices sorted along a Morton (Z-order) curve
+	 *  through the bounding box of the node positions, 21 bits per axis.
+	 */
+	std::vector<size_type> morton_order() const {
+		std::vector<size_type> order(num_active_points_);
+		if (num_active_points_ == 0) return order;
+		Point lo = positions_[0], hi = positions_[0];
+		for (size_type i = 1; i < num_active_points_; ++i)
+			for (int k = 0; k < 3; ++k) {
+				lo[k] = std::min(lo[k], positions_[i][k]);
+				hi[k] = std::max(hi[k], positions_[i][k]);
+			}
+		
+		// spread the low 21 bits of v so that two zeros follow each bit
+		auto spread = [](std::uint64_t v) {
+			v &= 0x1fffff;
+			v = (v | v << 32) & 0x1f00000000ffffull;
+			v = (v | v << 16) & 0x1f0000ff0000ffull;
+			v = (v | v << 8) & 0x100f00f00f00f00full;
+			v = (v | v << 4) & 0x10c30c30c30c30c3ull;
+			v = (v | v << 2) & 0x1249249249249249ull;
+			return v;
+		};
+		std::vector<std::uint64_t> code(num_active_points_);
+		for (size_type i = 0; i < num_active_points_; ++i) {
+			std::uint64_t c = 0;
+			for (int k = 0; k < 3; ++k) {
+				double extent = hi[k] - lo[k];
+				double t = extent > 0 ? (positions_[i][k] - lo[k]) / extent : 0.0;
+				c |= spread(std::uint64_t(t * 0x1fffff)) << k;
+			}
+			code[i] = c;
+			order[i] = i;
+		}
+		std::stable_sort(order.begin(), order.end(), [&code](size_type a, size_type b) {
+			return code[a] < code[b];
+		});
+		return order;
+	}
+	
+	/** Return the length of the edge with active index @a i: the cached
+	 *  one unless an endpoint may have moved since the last edge_lengths(),
+	 *  else one computed from the positions. Writes nothing.
+	 */
+	double cached_length(size_type i) const {
+		const internal_edge& ie = index_edge_map_[i2u_edges_[i]];
+		if ((moved_.get() & lengths_stale)
+		    || ((node_moved_[i2u_nodes_[ie.node_idx_1_]].get()
+		         | node_moved_[i2u_nodes_[ie.node_idx_2_]].get()) & lengths_moved))
+			return edge_length(i);
+		return lengths_[i];
+	}
+	
+	/** Compute the length of the edge with active index @a i */
+	double edge_length(size_type i) const {
+		const internal_edge& ie = index_edge_map_[i2u_edges_[i]];
+		return norm_2(positions_[ie.node_idx_1_] - positions_[ie.node_idx_2_]);
+	}
+	
+	/** Record that the position of node @a uid may have been written: set
+	 *  its moved bits, and queue it for each pass whose bit was clear.
+	 *  Safe to call from several threads at once.
+	 */
+	void mark_moved(size_type uid) {
+		unsigned fresh = ~node_moved_[uid].set(lengths_moved | grid_moved);
+		if (fresh & lengths_moved) lengths_moved_.push(uid);
+		if (fresh & grid_moved) grid_moved_.push(uid);
+	}
+	
+	/** Clear @a bit of every node queued in @a list, and empty the list */
+	void drop_moved(moved_list& list, unsigned bit) const {
+		for (size_type k = 0; k < list.size(); ++k)
+			node_moved_[list.uids[k]].reset(bit);
+		list.clear();
+	}
+	
+	/** Return true if @a uid is the UID of a node of this graph */
+	bool node_live(size_type uid) const {
+		return live_generation(node_gen_, uid) != stale_generation;
+	}
+	
+	// Integer coordinates of a spatial grid cell
+	struct grid_key {
+		long long c[3];
+		long long& operator[](int k) { return c[k]; }
+		long long operator[](int k) const { return c[k]; }
+		bool operator==(const grid_key& o) const {
+			return c[0] == o.c[0] && c[1] == o.c[1] && c[2] == o.c[2];
+		}
 	};
+	struct grid_hash {
+		std::size_t operator()(const grid_key& k) const {
+			std::uint64_t h = std::uint64_t(k.c[0]) * 0x9E3779B97F4A7C15ull;
+			h ^= std::uint64_t(k.c[1]) * 0xC2B2AE3D27D4EB4Full + (h << 6) + (h >> 2);
+			h ^= std::uint64_t(k.c[2]) * 0x165667B19E3779F9ull + (h << 6) + (h >> 2);
+			return std::size_t(h);
+		}
+	};
+	
+	/** Return the grid cell containing @a p */
+	grid_key grid_cell(const Point& p) const {
+		grid_key k;
+		for (int i = 0; i < 3; ++i)
+			k[i] = (long long)std::floor(p[i] / cell_size_);
+		return k;
+	}
+	
+	/** Record that node @a uid was added. Cheap: the grid is only brought
+	 *  up to date by the next spatial query. Moves are queued separately,
+	 *  by mark_moved().
+	 */
+	void grid_touch(size_type uid) {
+		if (moved_.get() & grid_stale) return;
+		grid_dirty_.push_back(uid);
+		// more touches than nodes: rebuilding is cheaper than replaying them
+		if (grid_dirty_.size() > num_active_points_ + 1)
+			moved_.set(grid_stale);
+	}
+	
+	/** Remove node @a uid from its grid cell, if the grid holds it */
+	void grid_erase(size_type uid) const {
+		if ((moved_.get() & grid_stale) || uid >= grid_of_.size() || !grid_in_[uid]) return;
+		std::vector<size_type>& cell = grid_[grid_of_[uid]];
+		auto it = std::find(cell.begin(), cell.end(), uid);
+		*it = cell.back();
+		cell.pop_back();
+		if (cell.empty()) grid_.erase(grid_of_[uid]);
+		grid_in_[uid] = 0;
+	}
+	
+	/** Put active node @a uid into the cell of its current position */
+	void grid_insert(size_type uid) const {
+		grid_key k = grid_cell(positions_[node_index_[uid]]);
+		grid_[k].push_back(uid);
+		grid_of_[uid] = k;
+		grid_in_[uid] = 1;
+		for (int i = 0; i < 3; ++i) {
+			grid_lo_[i] = std::min(grid_lo_[i], k[i]);
+			grid_hi_[i] = std::max(grid_hi_[i], k[i]);
+		}
+	}
+	
+	/** Return the nodes whose position satisfies @a keep, looking only in
+	 *  the grid cells overlapping the box [@a lo, @a hi]. @a keep must
+	 *  reject every position outside the box.
+	 */
+	template <typename Keep>
+	std::vector<Node> grid_collect(const Point& lo, const Point& hi, Keep keep) const {
+		std::vector<Node> result;
+		if (num_active_points_ == 0) return result;
+		grid_sync();
+		grid_key a = grid_cell(lo), b = grid_cell(hi);
+		double span = 1;
+		for (int k = 0; k < 3; ++k) {
+			a[k] = std::max(a[k], grid_lo_[k]);
+			b[k] = std::min(b[k], grid_hi_[k]);
+			if (a[k] > b[k]) return result;
+			span *= double(b[k] - a[k] + 1);
+		}
+		auto take = [&](const std::vector<size_type>& uids) {
+			for (size_type uid : uids)
+				if (keep(positions_[node_index_[uid]]))
+					result.push_back(Node(this, uid));
+		};
+		if (span > double(grid_.size())) {
+			// box covers most of the grid: walk occupied cells only
+			for (auto& cell : grid_)
+				take(cell.second);
+			return result;
+		}
+		for (long long x = a[0]; x <= b[0]; ++x)
+			for (long long y = a[1]; y <= b[1]; ++y)
+				for (long long z = a[2]; z <= b[2]; ++z) {
+					auto cell = grid_.find(grid_key{{x, y, z}});
+					if (cell != grid_.end()) take(cell->second);
+				}
+		return result;
+	}
+
+	/** Bring the spatial grid up to date with the node positions. Rebuilds
+	 *  from scratch when stale or when the node count has drifted far from
+	 *  the count the cell size was chosen for; otherwise re-files only the
+	 *  added and moved nodes.
+	 */
+	void grid_sync() const {
+		if ((moved_.get() & grid_stale) || num_active_points_ > 2 * grid_built_ + 8
+			|| 2 * num_active_points_ + 8 < grid_built_) {
+			grid_rebuild();
+			return;
+		}
+		if (grid_moved_.size() == 0 && grid_dirty_.empty()) return;
+		grid_of_.resize(num_points_);
+		grid_in_.resize(num_points_, 0);
+		for (size_type k = 0; k < grid_moved_.size(); ++k) {
+			size_type uid = grid_moved_.uids[k];
+			if (node_live(uid)) grid_refile(uid);
+		}
+		drop_moved(grid_moved_, grid_moved);
+		for (size_type uid : grid_dirty_)
+			if (node_live(uid)) grid_refile(uid);
+		grid_dirty_.clear();
+	}
+	
+	/** Move active node @a uid to the cell of its position, if it is not
+	 *  already filed there.
+	 */
+	void grid_refile(size_type uid) const {
+		if (grid_in_[uid] && grid_of_[uid] == grid_cell(positions_[node_index_[uid]])) return;
+		grid_erase(uid);
+		grid_insert(uid);
+	}
+	
+	/** Rebuild the spatial grid, sizing cells for about one node each over
+	 *  the bounding box of the nodes (flat dimensions are ignored).
+	 */
+	void grid_rebuild() const {
+		Point lo = positions_[0], hi = positions_[0];
+		for (size_type i = 1; i < num_active_points_; ++i)
+			for (int k = 0; k < 3; ++k) {
+				lo[k] = std::min(lo[k], positions_[i][k]);
+				hi[k] = std::max(hi[k], positions_[i][k]);
+			}
+		double volume = 1;
+		int dims = 0;
+		for (int k = 0; k < 3; ++k)
+			if (hi[k] > lo[k]) { volume *= hi[k] - lo[k]; ++dims; }
+		cell_size_ = dims ? std::pow(volume / num_active_points_, 1.0 / dims) : 1.0;
+		if (!(cell_size_ > 0) || !std::isfinite(cell_size_)) cell_size_ = 1.0;
+		
+		grid_.clear();
+		grid_.reserve(num_active_points_);
+		grid_of_.assign(num_points_, grid_key());
+		grid_in_.assign(num_points_, 0);
+		grid_lo_ = grid_cell(positions_[0]);
+		grid_hi_ = grid_lo_;
+		drop_moved(grid_moved_, grid_moved);
+		for (size_type i = 0; i < num_active_points_; ++i)
+			grid_insert(i2u_nodes_[i]);
+		grid_dirty_.clear();
+		grid_built_ = num_active_points_;
+		moved_.reset(grid_stale);
+	}
 	
 	// struct containing any information we need to keep about the edges
 	// @node_idx_1_ < @node_idx_2_ when added
@@ -1119,16 +2531,26 @@ size_type remove_edge(const Edge& e) {
 		edge_value_type e_val_;
 	};
 	
-	 // Container which holds the information of the Nodes
-	 typename std::vector<internal_node> points_;
+	 // Node data is kept as separate arrays so that loops touching only
+	 // positions or only values stream through contiguous memory.
+	 // positions_ and values_ are indexed by active index and are compacted
+	 // by remove_node; node_index_ is indexed by UID and holds the active
+	 // index of that node.
+	 std::vector<Point> positions_;
+	 std::vector<node_value_type> values_;
+	 std::vector<size_type> node_index_;
 	
 	 // Store the currently "active" set of nodes.
 	 std::vector<size_type> i2u_nodes_;   // Indexed by node idx
 	 
-	 // Counter to keep track of the size of the vector of Nodes which
-	 // have been part of the graph at any point.
-	 // num_points_ = max{UID_nodes} + 1 == points_.size()
+	 // Counter to keep track of the number of node UIDs in use or free.
+	 // num_points_ = max{UID_nodes} + 1 == node_index_.size()
 	 size_type num_points_ = 0;
+	 
+	 // UIDs of removed nodes and edges, reused first by add_node and
+	 // add_edge so UID-indexed storage does not grow with churn
+	 std::vector<size_type> free_node_uids_;
+	 std::vector<size_type> free_edge_uids_;
 	
 	 // Counter to keep track of number of active nodes
 	 // num_active_points_ == i2u_nodes_.size()
@@ -1161,8 +2583,7 @@ size_type remove_edge(const Edge& e) {
 	// Store the currently "active" set of edges.
 	std::vector<size_type> i2u_edges_;   // Indexed by active edge idx
 
-	 // Counter to keep track of the size of the vector of Edges which
-	 // have been part of the graph at any point.
+	 // Counter to keep track of the number of edge UIDs in use or free.
 	 // num_edges_ = max{UID_edges} + 1 == index_edge_map_.size()
 	 size_type num_edges_ = 0;
 	
@@ -1170,6 +2591,100 @@ size_type remove_edge(const Edge& e) {
 	// num_active_edges_ == i2u_edges_.size()
 	size_type num_active_edges_ = 0;
 	
+	// Degree of each node, indexed by active index, and the number of
+	// nodes of each degree; degree_count_.back() is never 0 unless the
+	// graph is empty, so degree_count_.size() - 1 is the max degree.
+	std::vector<size_type> degrees_;
+	std::vector<size_type> degree_count_ = std::vector<size_type>(1, 0);
+	
+	// Generation of each node and edge UID slot, checked by valid()
+	std::vector<size_type> node_gen_;
+	std::vector<size_type> edge_gen_;
+	
+	// Bits set by mutable position accesses and cleared by the pass that
+	// catches up with moved nodes. node_moved_ (indexed by UID) holds each
+	// node's lengths_moved and grid_moved bits. moved_ holds the graph-wide
+	// bits set by positions_changed(): lengths_stale means every length
+	// may be stale, grid_stale that the grid must be rebuilt. The atomics
+	// are relaxed and only stored to while a bit is clear, so a parallel
+	// loop writing positions neither races on them nor keeps moving their
+	// cache lines between cores.
+	static constexpr unsigned lengths_moved = 1;
+	static constexpr unsigned grid_moved = 2;
+	static constexpr unsigned grid_stale = 4;
+	static constexpr unsigned lengths_stale = 8;
+	struct moved_flags {
+		std::atomic<unsigned> bits;
+		explicit moved_flags(unsigned b = 0) : bits(b) {}
+		moved_flags(const moved_flags& o) : bits(o.get()) {}
+		moved_flags& operator=(const moved_flags& o) {
+			bits.store(o.get(), std::memory_order_relaxed);
+			return *this;
+		}
+		unsigned get() const { return bits.load(std::memory_order_relaxed); }
+		/** Set the bits @a b and return the bits set before */
+		unsigned set(unsigned b) {
+			unsigned old = get();
+			if ((old & b) != b) old = bits.fetch_or(b, std::memory_order_relaxed);
+			return old;
+		}
+		void reset(unsigned b) { bits.fetch_and(~b, std::memory_order_relaxed); }
+	};
+	mutable moved_flags moved_ = moved_flags(grid_stale);
+	mutable std::vector<moved_flags> node_moved_;
+	
+	// UIDs of the nodes whose moved bit for one pass is set, in the order
+	// they were marked. A node is appended only when its bit goes from
+	// clear to set, so at most num_points_ entries are in use and uids is
+	// kept at that size; threads claim entries with the atomic count.
+	struct moved_list {
+		std::vector<size_type> uids;
+		std::atomic<size_type> count;
+		moved_list() : count(0) {}
+		moved_list(const moved_list& o) : uids(o.uids), count(o.size()) {}
+		moved_list& operator=(const moved_list& o) {
+			uids = o.uids;
+			count.store(o.size(), std::memory_order_relaxed);
+			return *this;
+		}
+		size_type size() const { return count.load(std::memory_order_relaxed); }
+		void push(size_type uid) { uids[count.fetch_add(1, std::memory_order_relaxed)] = uid; }
+		void clear() { count.store(0, std::memory_order_relaxed); }
+	};
+	mutable moved_list lengths_moved_, grid_moved_;
+	
+	// Edge length cache, indexed by active edge index like i2u_edges_.
+	// add_edge() fills in the new edge's length; edge_lengths() recomputes
+	// the lengths of the edges at the nodes in lengths_moved_, or all of
+	// them if lengths_stale is set. Until then Edge::length() computes the
+	// lengths of those edges from the positions instead of reading lengths_.
+	std::vector<double> lengths_;
+	
+	// Spatial hash grid over node positions, built lazily by the first
+	// spatial query. grid_ maps a cell to the UIDs of the nodes in it;
+	// grid_of_ and grid_in_ (indexed by UID) give each node's cell.
+	// Additions are queued in grid_dirty_ and moved nodes in grid_moved_,
+	// and grid_sync() re-files just those. Removals are applied
+	// immediately.
+	// grid_lo_ and grid_hi_ bound the occupied cells.
+	mutable std::unordered_map<grid_key, std::vector<size_type>, grid_hash> grid_;
+	mutable std::vector<grid_key> grid_of_;
+	mutable std::vector<char> grid_in_;
+	mutable std::vector<size_type> grid_dirty_;
+	mutable grid_key grid_lo_, grid_hi_;
+	mutable double cell_size_ = 1.0;
+	mutable size_type grid_built_ = 0;
+	
+	// Greedy node and edge colorings, built by the first color query and
+	// then maintained incrementally. *_color_ and *_color_pos_ are indexed
+	// by UID and give each node's or edge's color and its position in
+	// *_classes_[color], the UIDs of that color.
+	static constexpr size_type no_color = size_type(-1);
+	mutable bool coloring_built_ = false;
+	mutable std::vector<size_type> node_color_, node_color_pos_;
+	mutable std::vector<size_type> edge_color_, edge_color_pos_;
+	mutable std::vector<std::vector<size_type>> node_classes_, edge_classes_;
+	
 };
 
 #endif // CME212_GRAPH_HPP
@@ -0,0 +1,244 @@
+#ifndef CME212_MASSSPRING_HPP
+#define CME212_MASSSPRING_HPP
+
+/** @file MassSpring.hpp
+ * @brief Mass-spring time stepping on contiguous arrays
+ */
+
+#include <algorithm>
+#include <vector>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "CME212/Point.hpp"
+
+
+/** @class MassSpring
+ * @brief Symplectic Euler integrator for a graph of point masses joined by
+ *        linear springs.
+ *
+ * G is a graph with contiguous node data, i.e. positions() and values()
+ * Spans indexed by node index (see hw2/Graph_2259.hpp). Its node values
+ * must have members @a vel (Point) and @a mass (double), and its edge values
+ * members @a K (stiffness) and @a L (rest length).
+ *
+ * The kernel keeps its own copy of the node positions, velocities and
+ * forces, each node's x, y and z padded to four doubles, so one node is one
+ * AVX register. Four springs are evaluated at a time: their endpoint
+ * differences are transposed into x, y and z vectors for the length and
+ * force, and transposed back so each force is added to its endpoints with
+ * one vector add. Built without AVX2 (-mavx2), the same loops run scalar;
+ * the two paths agree to rounding.
+ *
+ * step() only updates the kernel's copy. Call store() before reading
+ * positions or velocities from the graph, and load() after writing them.
+ *
+ * A node with mass 0 is fixed: step() leaves its position alone and sets
+ * its velocity to 0. Masses must not be negative or NaN. A spring of zero
+ * length exerts no force.
+ *
+ * Edge endpoints, K, L and masses are read by the constructor and by
+ * rebuild(); call rebuild() after adding or removing nodes or edges or
+ * changing those values.
+ */
+template <typename G>
+class MassSpring {
+ public:
+  using size_type = typename G::size_type;
+
+  /** Construct a kernel for @a graph, which must outlive it. */
+  explicit MassSpring(G& graph) : graph_(&graph) { rebuild(); }
+
+  // A copy's arrays could start at a different offset from 32 bytes
+  MassSpring(const MassSpring&) = delete;
+  MassSpring& operator=(const MassSpring&) = delete;
+  MassSpring(MassSpring&&) = default;
+  MassSpring& operator=(MassSpring&&) = default;
+
+  /** Re-read the edges, spring constants, masses, positions and
+   *  velocities from the graph.
+   */
+  void rebuild() {
+    size_type n = graph_->num_nodes(), m = graph_->num_edges();
+    assert(n <= size_type(std::numeric_limits<int>::max() / 4));
+    e1_.resize(m); e2_.resize(m); k_.resize(m); l_.resize(m);
+    for (size_type i = 0; i < m; ++i) {
+      auto e = graph_->edge(i);
+      e1_[i] = int(e.node1().index());
+      e2_[i] = int(e.node2().index());
+      k_[i] = e.value().K;
+      l_[i] = e.value().L;
+    }
+    inv_m_.resize(n);
+    free_.resize(n);
+    auto values = graph_->values();
+    for (size_type i = 0; i < n; ++i) {
+      double mass = values[i].mass;
+      assert(mass >= 0);
+      inv_m_[i] = mass > 0 ? 1.0 / mass : 0.0;
+      free_[i] = mass > 0 ? 1.0 : 0.0;
+    }
+    for (auto* v : {&x_, &v_, &f_})
+      v->assign(4 * n + 4, 0.0);   // room to align to 32 bytes
+    load();
+  }
+
+  /** Re-read positions and velocities from the graph. */
+  void load() {
+    assert(4 * graph_->num_nodes() + 4 == x_.size());
+    // read-only views, so the graph's position-derived caches stay valid
+    const G& graph = *graph_;
+    auto positions = graph.positions();
+    auto values = graph.values();
+    double* x = quads(x_);
+    double* v = quads(v_);
+    for (size_type i = 0; i < positions.size(); ++i)
+      for (int k = 0; k < 3; ++k) {
+        x[4 * i + k] = positions[i][k];
+        v[4 * i + k] = values[i].vel[k];
+      }
+    stored_ = true;
+  }
+
+  /** Write positions and velocities back to the graph, if a step was
+   *  taken since the last load() or store().
+   */
+  void store() {
+    if (stored_) return;
+    assert(4 * graph_->num_nodes() + 4 == x_.size());
+    auto positions = graph_->positions();
+    auto values = graph_->values();
+    const double* x = quads(x_);
+    const double* v = quads(v_);
+    for (size_type i = 0; i < positions.size(); ++i) {
+      positions[i] = Point(x[4 * i], x[4 * i + 1], x[4 * i + 2]);
+      values[i].vel = Point(v[4 * i], v[4 * i + 1], v[4 * i + 2]);
+    }
+    stored_ = true;
+  }
+
+  /** Advance the kernel's copy of the graph by one time step.
+   * @param[in] dt      Time step
+   * @param[in] gravity Uniform acceleration applied to every node
+   * @post for every node i of nonzero mass, with F the spring force at the
+   *       old positions:
+   *       new vel = old vel + dt * (F / mass + gravity)
+   *       new position = old position + dt * new vel
+   * @post nodes of mass 0 keep their position and have velocity 0
+   *
+   * The graph itself is updated by store().
+   * Complexity: O(num_nodes() + num_edges()).
+   */
+  void step(double dt, const Point& gravity = Point(0, 0, 0)) {
+    assert(inv_m_.size() == graph_->num_nodes() && e1_.size() == graph_->num_edges());
+    std::fill(f_.begin(), f_.end(), 0.0);
+    forces();
+    integrate(dt, gravity);
+    stored_ = false;
+  }
+
+ private:
+  G* graph_;
+  // Edges: endpoint node indices, stiffness, rest length
+  std::vector<int> e1_, e2_;
+  std::vector<double> k_, l_;
+  // Nodes: position, velocity and net force as (x, y, z, 0) quads starting
+  // at the first 32-byte boundary of the vector; 1 / mass, and 1 unless fixed
+  std::vector<double> x_, v_, f_;
+  std::vector<double> inv_m_, free_;
+  // false once step() has run since the last load() or store()
+  bool stored_;
+
+  /** Return the first 32-byte aligned element of @a v. */
+  static double* quads(std::vector<double>& v) {
+    std::uintptr_t a = reinterpret_cast<std::uintptr_t>(v.data());
+    return v.data() + (32 - a % 32) % 32 / sizeof(double);
+  }
+
+  /** Add the spring force of every edge to its endpoints:
+   *  K * (|d| - L) / |d| * d on node1 and its negation on node2, with
+   *  d = position(node2) - position(node1), or 0 if |d| = 0.
+   */
+  void forces() {
+    const double* x = quads(x_);
+    double* f = quads(f_);
+    std::size_t i = 0, m = e1_.size();
+#if defined(__AVX2__)
+    const __m256d zero = _mm256_setzero_pd();
+    for (; i + 4 <= m; i += 4) {
+      __m256d d[4];
+      for (int j = 0; j < 4; ++j)
+        d[j] = _mm256_sub_pd(_mm256_load_pd(x + 4 * e2_[i + j]), _mm256_load_pd(x + 4 * e1_[i + j]));
+      // transpose four (x, y, z, 0) rows into x, y and z columns
+      __m256d t0 = _mm256_unpacklo_pd(d[0], d[1]), t1 = _mm256_unpackhi_pd(d[0], d[1]);
+      __m256d t2 = _mm256_unpacklo_pd(d[2], d[3]), t3 = _mm256_unpackhi_pd(d[2], d[3]);
+      __m256d dx = _mm256_permute2f128_pd(t0, t2, 0x20);
+      __m256d dy = _mm256_permute2f128_pd(t1, t3, 0x20);
+      __m256d dz = _mm256_permute2f128_pd(t0, t2, 0x31);
+      __m256d len = _mm256_sqrt_pd(_mm256_add_pd(_mm256_add_pd(
+          _mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)), _mm256_mul_pd(dz, dz)));
+      __m256d s = _mm256_div_pd(_mm256_mul_pd(_mm256_loadu_pd(&k_[i]),
+                                              _mm256_sub_pd(len, _mm256_loadu_pd(&l_[i]))), len);
+      s = _mm256_and_pd(s, _mm256_cmp_pd(len, zero, _CMP_GT_OQ));
+      // back to one (x, y, z, 0) force per spring
+      __m256d sl = _mm256_permute2f128_pd(s, s, 0x00), sh = _mm256_permute2f128_pd(s, s, 0x11);
+      __m256d sj[4] = {_mm256_permute_pd(sl, 0x0), _mm256_permute_pd(sl, 0xF),
+                       _mm256_permute_pd(sh, 0x0), _mm256_permute_pd(sh, 0xF)};
+      for (int j = 0; j < 4; ++j) {
+        __m256d fj = _mm256_mul_pd(sj[j], d[j]);
+        double* a = f + 4 * e1_[i + j];
+        double* b = f + 4 * e2_[i + j];
+        _mm256_store_pd(a, _mm256_add_pd(_mm256_load_pd(a), fj));
+        _mm256_store_pd(b, _mm256_sub_pd(_mm256_load_pd(b), fj));
+      }
+    }
+#endif
+    for (; i < m; ++i) {
+      const double* a = x + 4 * e1_[i];
+      const double* b = x + 4 * e2_[i];
+      double dx = b[0] - a[0], dy = b[1] - a[1], dz = b[2] - a[2];
+      double len = std::sqrt(dx * dx + dy * dy + dz * dz);
+      double s = len > 0 ? k_[i] * (len - l_[i]) / len : 0.0;
+      double* fa = f + 4 * e1_[i];
+      double* fb = f + 4 * e2_[i];
+      fa[0] += s * dx; fa[1] += s * dy; fa[2] += s * dz;
+      fb[0] -= s * dx; fb[1] -= s * dy; fb[2] -= s * dz;
+    }
+  }
+
+  /** Symplectic Euler update of every node. Fixed nodes have inverse
+   *  mass 0 and free_ 0, so their velocity is zeroed.
+   */
+  void integrate(double dt, const Point& g) {
+    double* x = quads(x_);
+    double* v = quads(v_);
+    const double* f = quads(f_);
+    std::size_t n = inv_m_.size();
+#if defined(__AVX2__)
+    __m256d vdt = _mm256_set1_pd(dt), vg = _mm256_setr_pd(g[0], g[1], g[2], 0.0);
+    for (std::size_t i = 0; i < n; ++i) {
+      __m256d acc = _mm256_add_pd(_mm256_mul_pd(_mm256_load_pd(f + 4 * i),
+                                                _mm256_broadcast_sd(&inv_m_[i])), vg);
+      __m256d vel = _mm256_mul_pd(_mm256_add_pd(_mm256_load_pd(v + 4 * i), _mm256_mul_pd(vdt, acc)),
+                                  _mm256_broadcast_sd(&free_[i]));
+      _mm256_store_pd(v + 4 * i, vel);
+      _mm256_store_pd(x + 4 * i, _mm256_add_pd(_mm256_load_pd(x + 4 * i), _mm256_mul_pd(vdt, vel)));
+    }
+#else
+    for (std::size_t i = 0; i < n; ++i)
+      for (int k = 0; k < 3; ++k) {
+        v[4 * i + k] = (v[4 * i + k] + dt * (f[4 * i + k] * inv_m_[i] + g[k])) * free_[i];
+        x[4 * i + k] += dt * v[4 * i + k];
+      }
+#endif
+  }
+};
+
+#endif // CME212_MASSSPRING_HPP
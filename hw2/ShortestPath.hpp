@@ -0,0 +1,237 @@
+#ifndef CME212_SHORTESTPATH_HPP
+#define CME212_SHORTESTPATH_HPP
+
+/** @file ShortestPath.hpp
+ * @brief Reusable single-source shortest path searches over a Graph
+ */
+
+#include <algorithm>
+#include <vector>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <utility>
+
+
+/** @class ShortestPath
+ * @brief Dijkstra and breadth-first searches that keep their buffers
+ *        between queries.
+ *
+ * Works on any graph type G with the Graph interface: G::node(i),
+ * num_nodes(), Node::index(), Node::edge_begin()/edge_end() and
+ * Edge::node1()/node2(). Distance, parent and visited state live in
+ * arrays indexed by node index and sized to num_nodes(). Each query
+ * takes a new epoch; an entry only counts if its stamp equals the
+ * current epoch, so starting a query costs O(1) instead of O(num_nodes()).
+ *
+ * Results refer to the last query and are invalidated by the next one,
+ * and by any change to the graph's nodes.
+ *
+ * Constructed from a FilteredView, searches stay inside the view: nodes it
+ * rejects are never reached. Indices and nodes are still the graph's own.
+ *
+ * @code
+ * ShortestPath<GraphType> sp(graph);
+ * sp.dijkstra(source);                      // weights are Edge::length()
+ * if (sp.reached(target)) use(sp.distance(target), sp.path_to(target));
+ * @endcode
+ */
+template <typename G>
+class ShortestPath {
+ public:
+  using graph_type = G;
+  using node_type = typename G::node_type;
+  using edge_type = typename G::edge_type;
+  using size_type = typename G::size_type;
+
+  /** Construct a search engine for @a graph, which must outlive it. */
+  explicit ShortestPath(const G& graph) : graph_(&graph) {}
+
+  /** Construct a search engine restricted to the nodes of @a view, a
+   *  FilteredView of a graph of type G. The graph must outlive it.
+   */
+  template <typename View>
+  explicit ShortestPath(const View& view)
+      : graph_(&view.graph()),
+        keep_([view](const node_type& n) { return view.contains(n); }) {}
+
+  /** Run Dijkstra's algorithm from @a source, weighting edges by length.
+   * @pre @a source is a node of the graph and all lengths are >= 0
+   * @param[in] max_dist Stop once every node closer than this is settled
+   * @return the number of nodes reached
+   */
+  size_type dijkstra(const node_type& source,
+                     double max_dist = std::numeric_limits<double>::infinity()) {
+    return dijkstra(source, [](const edge_type& e) { return e.length(); }, max_dist);
+  }
+
+  /** Run Dijkstra's algorithm from @a source.
+   * @pre @a source is a node of the graph
+   * @param[in] weight   Functor edge_type -> double, with weight(e) >= 0
+   * @param[in] max_dist Stop once every node closer than this is settled
+   * @return the number of nodes reached
+   * @post for every reached node n, distance(n) is the length of the
+   *       shortest path from @a source to n, if that is <= max_dist
+   *
+   * Complexity: O((E' + N') log E') for the E' edges and N' nodes touched.
+   */
+  template <typename Weight>
+  size_type dijkstra(const node_type& source, Weight weight,
+                     double max_dist = std::numeric_limits<double>::infinity()) {
+    start(source);
+    heap_.clear();
+    heap_.push_back(std::make_pair(0.0, source.index()));
+    while (!heap_.empty()) {
+      std::pop_heap(heap_.begin(), heap_.end(), std::greater<entry>());
+      entry top = heap_.back();
+      heap_.pop_back();
+      size_type u = top.second;
+      // skip stale heap entries
+      if (done_[u] == epoch_ || top.first > dist_[u]) continue;
+      if (top.first > max_dist) break;
+      done_[u] = epoch_;
+
+      node_type n = graph_->node(u);
+      for (auto it = n.edge_begin(); it != n.edge_end(); ++it) {
+        edge_type e = *it;
+        size_type v = other(e, u);
+        if (!keeps(e, v)) continue;
+        double d = top.first + weight(e);
+        if (seen_[v] != epoch_ || d < dist_[v]) {
+          reach(v, u, d);
+          heap_.push_back(std::make_pair(d, v));
+          std::push_heap(heap_.begin(), heap_.end(), std::greater<entry>());
+        }
+      }
+    }
+    return reached_;
+  }
+
+  /** Run a breadth-first search from @a source; distances count edges.
+   * @pre @a source is a node of the graph
+   * @param[in] max_hops Do not expand nodes this many edges away or more
+   * @return the number of nodes reached
+   *
+   * Complexity: O(E' + N') for the E' edges and N' nodes touched.
+   */
+  size_type bfs(const node_type& source,
+                size_type max_hops = std::numeric_limits<size_type>::max()) {
+    start(source);
+    queue_.clear();
+    queue_.push_back(source.index());
+    for (std::size_t head = 0; head < queue_.size(); ++head) {
+      size_type u = queue_[head];
+      done_[u] = epoch_;
+      if (dist_[u] >= max_hops) continue;
+      node_type n = graph_->node(u);
+      for (auto it = n.edge_begin(); it != n.edge_end(); ++it) {
+        edge_type e = *it;
+        size_type v = other(e, u);
+        if (seen_[v] == epoch_ || !keeps(e, v)) continue;
+        reach(v, u, dist_[u] + 1);
+        queue_.push_back(v);
+      }
+    }
+    return reached_;
+  }
+
+  /** Return true if the last search reached @a n. */
+  bool reached(const node_type& n) const {
+    return n.index() < seen_.size() && seen_[n.index()] == epoch_;
+  }
+
+  /** Return the distance to @a n found by the last search, or infinity
+   *  if it was not reached.
+   */
+  double distance(const node_type& n) const {
+    return reached(n) ? dist_[n.index()] : std::numeric_limits<double>::infinity();
+  }
+
+  /** Return the node preceding @a n on its shortest path.
+   * @pre reached(@a n) and @a n is not the source
+   */
+  node_type parent(const node_type& n) const {
+    assert(reached(n) && parent_[n.index()] != n.index());
+    return graph_->node(parent_[n.index()]);
+  }
+
+  /** Return the nodes on the shortest path from the source to @a n, in
+   *  order, or an empty vector if @a n was not reached.
+   */
+  std::vector<node_type> path_to(const node_type& n) const {
+    std::vector<node_type> path;
+    if (!reached(n)) return path;
+    // walk back to the source first; nodes need not be assignable
+    std::vector<size_type> trail(1, n.index());
+    while (parent_[trail.back()] != trail.back())
+      trail.push_back(parent_[trail.back()]);
+    path.reserve(trail.size());
+    for (auto it = trail.rbegin(); it != trail.rend(); ++it)
+      path.push_back(graph_->node(*it));
+    return path;
+  }
+
+ private:
+  using entry = std::pair<double, size_type>;
+
+  const G* graph_;
+  // Node filter of a view; empty to search the whole graph
+  std::function<bool(const node_type&)> keep_;
+  // Per-node state, valid only where the stamp equals epoch_
+  std::vector<double> dist_;
+  std::vector<size_type> parent_;
+  std::vector<unsigned> seen_;  // reached by the current search
+  std::vector<unsigned> done_;  // settled by the current search
+  unsigned epoch_ = 0;
+  size_type reached_ = 0;
+  // Work lists, kept to reuse their storage
+  std::vector<entry> heap_;
+  std::vector<size_type> queue_;
+
+  /** Begin a new search from @a source. */
+  void start(const node_type& source) {
+    size_type n = graph_->num_nodes();
+    if (dist_.size() != n) {
+      dist_.resize(n);
+      parent_.resize(n);
+      seen_.resize(n, 0);
+      done_.resize(n, 0);
+    }
+    if (++epoch_ == 0) {
+      // stamps wrapped around: clear them once
+      std::fill(seen_.begin(), seen_.end(), 0);
+      std::fill(done_.begin(), done_.end(), 0);
+      epoch_ = 1;
+    }
+    reached_ = 0;
+    size_type s = source.index();
+    assert(s < n);
+    assert(!keep_ || keep_(source));
+    reach(s, s, 0);
+  }
+
+  /** Record a path to node @a v through @a u of length @a d. */
+  void reach(size_type v, size_type u, double d) {
+    if (seen_[v] != epoch_) {
+      seen_[v] = epoch_;
+      ++reached_;
+    }
+    dist_[v] = d;
+    parent_[v] = u;
+  }
+
+  /** Return true if node @a v, an endpoint of @a e, may be searched. */
+  bool keeps(const edge_type& e, size_type v) const {
+    if (!keep_) return true;
+    return e.node2().index() == v ? keep_(e.node2()) : keep_(e.node1());
+  }
+
+  /** Return the index of the endpoint of @a e that is not node @a u. */
+  static size_type other(const edge_type& e, size_type u) {
+    size_type v = e.node2().index();
+    return v != u ? v : e.node1().index();
+  }
+};
+
+#endif // CME212_SHORTESTPATH_HPP
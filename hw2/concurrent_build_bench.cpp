@@ -0,0 +1,107 @@
+/** @file concurrent_build_bench.cpp
+ * @brief Mesh construction time of Graph_2259.hpp through
+ *        Graph::ConcurrentBuilder for 1 to 32 threads.
+ *
+ * Each thread takes a slab of z-layers of a 3D grid, adds its nodes, and
+ * then adds the 6-neighbor edges of the nodes it owns. Node indices are
+ * exchanged through a shared table after a barrier. seal() uses the same
+ * number of threads. Prints the time of the parallel phase and of seal()
+ * for every thread count, and the speedup of the total over a plain
+ * single-threaded add_node()/add_edge() build of the same mesh. Every
+ * build goes into the same graph after clear() and checks that all its
+ * nodes and edges come out valid.
+ *
+ * Build: g++ -std=c++14 -O3 -pthread -I<dir with CME212/> concurrent_build_bench.cpp
+ * Usage: ./a.out [side]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "Graph_2259.hpp"
+
+using GraphType = Graph<int, int>;
+using size_type = GraphType::size_type;
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/** Add the nodes of z-layers [z0, z1) and record their indices in @a id. */
+void add_layers(GraphType::ConcurrentBuilder& builder, std::vector<size_type>& id,
+                int side, int z0, int z1) {
+  for (int z = z0; z < z1; ++z)
+    for (int y = 0; y < side; ++y)
+      for (int x = 0; x < side; ++x)
+        id[(z * side + y) * side + x] = builder.add_node(Point(x, y, z));
+}
+
+/** Add the edges from nodes of z-layers [z0, z1) to their +x, +y, +z neighbors. */
+void link_layers(GraphType::ConcurrentBuilder& builder, const std::vector<size_type>& id,
+                 int side, int z0, int z1) {
+  for (int z = z0; z < z1; ++z)
+    for (int y = 0; y < side; ++y)
+      for (int x = 0; x < side; ++x) {
+        int c = (z * side + y) * side + x;
+        if (x + 1 < side) builder.add_edge(id[c], id[c + 1]);
+        if (y + 1 < side) builder.add_edge(id[c], id[c + side]);
+        if (z + 1 < side) builder.add_edge(id[c], id[c + side * side]);
+      }
+}
+
+int main(int argc, char** argv) {
+  int side = argc > 1 ? std::atoi(argv[1]) : 60;
+  int n = side * side * side;
+
+  auto start = std::chrono::steady_clock::now();
+  GraphType serial;
+  for (int c = 0; c < n; ++c)
+    serial.add_node(Point(c % side, c / side % side, c / (side * side)));
+  for (int c = 0; c < n; ++c) {
+    int x = c % side, y = c / side % side, z = c / (side * side);
+    if (x + 1 < side) serial.add_edge(serial.node(c), serial.node(c + 1));
+    if (y + 1 < side) serial.add_edge(serial.node(c), serial.node(c + side));
+    if (z + 1 < side) serial.add_edge(serial.node(c), serial.node(c + side * side));
+  }
+  std::cout << serial.num_nodes() << " nodes, " << serial.num_edges() << " edges\n";
+  double serial_time = seconds_since(start);
+  std::cout << "serial add_node/add_edge  " << serial_time << " s\n";
+
+  GraphType g;  // rebuilt after clear(), whose UID slots stay freed
+  for (int threads : {1, 2, 4, 8, 16, 32}) {
+    g.clear();
+    std::vector<size_type> id(n);
+    GraphType::ConcurrentBuilder builder(g, threads);
+
+    start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t)
+      pool.emplace_back(add_layers, std::ref(builder), std::ref(id), side,
+                        side * t / threads, side * (t + 1) / threads);
+    for (auto& th : pool) th.join();
+    pool.clear();
+    for (int t = 0; t < threads; ++t)
+      pool.emplace_back(link_layers, std::ref(builder), std::cref(id), side,
+                        side * t / threads, side * (t + 1) / threads);
+    for (auto& th : pool) th.join();
+    double parallel = seconds_since(start);
+
+    start = std::chrono::steady_clock::now();
+    builder.seal();
+    double seal = seconds_since(start);
+
+    if (g.num_nodes() != serial.num_nodes() || g.num_edges() != serial.num_edges())
+      std::cout << "size mismatch: ";
+    size_type invalid = 0;
+    for (size_type i = 0; i < g.num_nodes(); ++i) invalid += !g.node(i).valid();
+    for (size_type i = 0; i < g.num_edges(); ++i) invalid += !g.edge(i).valid();
+    if (invalid != 0) std::cout << invalid << " invalid nodes and edges: ";
+    std::cout << threads << " threads  parallel " << parallel << " s, seal " << seal
+              << " s, total " << parallel + seal << " s ("
+              << serial_time / (parallel + seal) << "x)\n";
+  }
+  return 0;
+}
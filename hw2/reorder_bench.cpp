@@ -0,0 +1,92 @@
+/** @file reorder_bench.cpp
+ * @brief Neighbor traversal time of Graph_2259.hpp before and after
+ *        Graph::reorder().
+ *
+ * Builds a 3D grid mesh whose nodes are added in random order, as meshes
+ * read from arbitrary files are, and times a sweep that visits every node
+ * and reads the positions of its neighbors through IncidentIterator. The
+ * sweep is repeated after renumbering with reverse Cuthill-McKee and, on
+ * a fresh copy of the mesh, with Morton order. reorder() includes the
+ * compact() pass that renumbers the UIDs keying the adjacency maps.
+ *
+ * Build: g++ -std=c++14 -O3 -I<dir with CME212/> reorder_bench.cpp
+ * Usage: ./a.out [side] [passes]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "Graph_2259.hpp"
+
+using GraphType = Graph<int, int>;
+using NodeType = GraphType::node_type;
+
+/** Build a side^3 grid mesh with 6-neighbor edges, nodes in shuffled order. */
+void build(GraphType& g, int side) {
+  int n = side * side * side;
+  std::vector<int> slot(n);
+  for (int i = 0; i < n; ++i) slot[i] = i;
+  std::shuffle(slot.begin(), slot.end(), std::mt19937(212));
+
+  std::vector<int> index(n);
+  for (int k = 0; k < n; ++k) {
+    int c = slot[k];
+    index[c] = k;
+    g.add_node(Point(c % side, c / side % side, c / (side * side)));
+  }
+  for (int c = 0; c < n; ++c) {
+    int x = c % side, y = c / side % side, z = c / (side * side);
+    if (x + 1 < side) g.add_edge(g.node(index[c]), g.node(index[c + 1]));
+    if (y + 1 < side) g.add_edge(g.node(index[c]), g.node(index[c + side]));
+    if (z + 1 < side) g.add_edge(g.node(index[c]), g.node(index[c + side * side]));
+  }
+}
+
+/** Time @a passes sweeps over all nodes and their neighbors' positions. */
+double sweep(const GraphType& g, int passes) {
+  double sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int pass = 0; pass < passes; ++pass)
+    for (unsigned i = 0; i < g.num_nodes(); ++i) {
+      const NodeType n = g.node(i);
+      for (auto it = n.edge_begin(); it != n.edge_end(); ++it) {
+        const NodeType m = (*it).node2();
+        sum += m.position().x;
+      }
+    }
+  double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  if (sum < 0) std::cout << sum;  // keep the loop
+  return s / passes;
+}
+
+int main(int argc, char** argv) {
+  int side = argc > 1 ? std::atoi(argv[1]) : 40;
+  int passes = argc > 2 ? std::atoi(argv[2]) : 5;
+
+  GraphType g;
+  build(g, side);
+  std::cout << g.num_nodes() << " nodes, " << g.num_edges() << " edges\n";
+  double t0 = sweep(g, passes);
+  std::cout << "shuffled  " << t0 << " s per sweep\n";
+
+  auto start = std::chrono::steady_clock::now();
+  g.reorder(GraphType::reorder_strategy::reverse_cuthill_mckee);
+  double cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  double t1 = sweep(g, passes);
+  std::cout << "RCM       " << t1 << " s per sweep (" << t0 / t1 << "x), reorder took "
+            << cost << " s\n";
+
+  GraphType h;
+  build(h, side);
+  start = std::chrono::steady_clock::now();
+  h.reorder(GraphType::reorder_strategy::morton);
+  cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  double t2 = sweep(h, passes);
+  std::cout << "Morton    " << t2 << " s per sweep (" << t0 / t2 << "x), reorder took "
+            << cost << " s\n";
+  return 0;
+}
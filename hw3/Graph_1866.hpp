@@ -9,6 +9,10 @@
 #include <vector>
 #include <set>
 #include <tuple>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 #include <cassert>
 
 #include "CME212/Util.hpp"
@@ -26,6 +30,7 @@ class Graph {
 
   struct node_element;
   struct edge_element;
+  template <typename T> class element_pool;
   // HW0: YOUR CODE HERE
   // Use this space for declarations of important internal types you need
   // later in the Graph's definition.
@@ -88,10 +93,17 @@ class Graph {
     // HW0: YOUR CODE HERE
   }
 
-  /** Default destructor */
+  /** Destructor. Node and edge records live in the graph's pools, which
+   * free their storage in whole chunks. */
   ~Graph() {
+    node_pool.release(nodes.begin(), nodes.end());
+    edge_pool.release(edges.begin(), edges.end());
   }
 
+  // Records are owned by this graph's pools; copies would alias them.
+  Graph(const Graph&) = delete;
+  Graph& operator=(const Graph&) = delete;
+
   // Remove methods
   size_type remove_node ( const Node & n) {
     if (has_node(n)){
@@ -106,11 +118,13 @@ class Graph {
         ++it;
       }
 
-      //remove node
+      //remove node and hand its record back to the pool
       auto idx = n.n->idx;
       nodes[n_nodes-1]->idx = idx;
       std::swap(nodes[n.n->idx],nodes[n_nodes-1]);
       nodes[n_nodes-1]->idx = -1;
+      node_pool.destroy(nodes.back());
+      nodes.pop_back();
       --n_nodes;
     }
 
@@ -163,6 +177,8 @@ class Graph {
       edges[n_edges-1]->idx = idx;
       std::swap(edges[idx],edges[n_edges-1]);
       edges[n_edges-1]->idx = -1;
+      edge_pool.destroy(ee);
+      edges.pop_back();
       --n_edges;
     }
 
@@ -170,6 +186,10 @@ class Graph {
   }
 
   size_type remove_edge ( const Edge & ee) {
+    // a removed edge's record may already belong to another edge
+    if (ee.g != this || ee.gen != edge_pool.generation(ee.e)) {
+      return 0;
+    }
     return remove_edge(ee.node1(),ee.node2());
   }
   edge_iterator remove_edge ( edge_iterator e_it ) {
@@ -203,7 +223,7 @@ class Graph {
      * @endcode
      */
     Node()
-      : g(nullptr), n(nullptr) {
+      : g(nullptr), n(nullptr), gen(0) {
     }
 
     size_type id() const {
@@ -233,7 +253,9 @@ class Graph {
      */
     bool operator==(const Node& n) const {
       // HW0: YOUR CODE HERE
-      if(this->g == n.g && this->n->id == n.n->id){
+      // same record and generation; a stale node never equals the node
+      // that took over its slot
+      if(this->g == n.g && this->n == n.n && this->gen == n.gen){
         return true;
       }
       return false;
@@ -282,9 +304,10 @@ class Graph {
    private:
     const graph_type* g; // pointer to graph
     node_element* n; // pointer to node element
+    size_type gen; // generation of n's pool slot when this node was made
 
     Node(const graph_type* g_, node_element* n_)
-      : g(g_), n(n_) {
+      : g(g_), n(n_), gen(element_pool<node_element>::generation(n_)) {
       }
 
     // Allow Graph to access Node's private member data and functions.
@@ -318,10 +341,9 @@ class Graph {
    */
    Node add_node(const Point& position, const node_value_type & val = node_value_type ()) {
      std::set<edge_element*> s;
-     node_element* e = new node_element{position,next_node_id,s,val,n_nodes}; // allocate on heap
+     node_element* e = node_pool.create(position,next_node_id,s,val,n_nodes); // allocate from the pool
 
      nodes.push_back(e);
-     std::swap(nodes[n_nodes],nodes.back());
      ++next_node_id;
      ++n_nodes;
 
@@ -330,12 +352,16 @@ class Graph {
   /** Determine if a Node belongs to this Graph
    * @return True if @a n is currently a Node of this Graph
    *
+   * A removed node's record slot may be reused by a later add_node; the
+   * slot's generation tells the two apart. Node objects must not be used
+   * at all after clear(), which frees the slots.
+   *
    * Complexity: O(1).
    */
   bool has_node(const Node& n_) const {
     // HW0: YOUR CODE HERE
 
-    if (n_.n->idx < size()){
+    if (n_.g == this && n_.gen == node_pool.generation(n_.n)){
       return true;
     }
     return false;
@@ -366,7 +392,7 @@ class Graph {
    public:
     /** Construct an invalid Edge. */
     Edge() :
-      g(nullptr), e(nullptr) {
+      g(nullptr), e(nullptr), gen(0), flip(false) {
       // HW0: YOUR CODE HERE
     }
 
@@ -391,13 +417,13 @@ class Graph {
     }
     /** Return a node of this Edge */
     Node node1() const {
-      return Node(this->g, this->e->n1);
+      return Node(this->g, this->flip ? this->e->n2 : this->e->n1);
     }
 
     /** Return the other node of this Edge */
     Node node2() const {
       // HW0: YOUR CODE HERE
-      return Node(this->g, this->e->n2);
+      return Node(this->g, this->flip ? this->e->n1 : this->e->n2);
     }
 
     /** Test whether this edge and @a e are equal.
@@ -405,7 +431,9 @@ class Graph {
      * Equal edges represent the same undirected edge between two nodes.
      */
      bool operator==(const Edge& e) const {
-       if(this->g == e.g && ((this->e->n1->id == e.e->n1->id && this->e->n2->id == e.e->n2->id) || (this->e->n1->id == e.e->n2->id && this->e->n2->id == e.e->n1->id))) {
+       // a pair of nodes has at most one edge record, so comparing records
+       // compares endpoints; the generation keeps stale edges apart
+       if(this->g == e.g && this->e == e.e && this->gen == e.gen) {
          return true;
        }
        return false;
@@ -429,9 +457,11 @@ class Graph {
 
     const graph_type* g;
     edge_element* e;
+    size_type gen; // generation of e's pool slot when this edge was made
+    bool flip; // true if node1() is e->n2, as seen from an incident iterator
 
-    Edge(const graph_type* g_, edge_element* e_)
-      : g(g_), e(e_) {
+    Edge(const graph_type* g_, edge_element* e_, bool flip_ = false)
+      : g(g_), e(e_), gen(element_pool<edge_element>::generation(e_)), flip(flip_) {
       }
 
     // HW0: YOUR CODE HERE
@@ -501,22 +531,26 @@ class Graph {
    Edge add_edge(const Node& a, const Node& b) {
      // HW0: YOUR CODE HERE
 
-     edge_element* e;
-
-     e = new edge_element{a.n,b.n, edge_value_type (), n_edges};
-
      if (!(has_edge(a,b)) && has_node(a) && has_node(b)){
+       edge_element* e = edge_pool.create(a.n,b.n, edge_value_type (), n_edges);
        edges.push_back(e);
-       std::swap(edges[n_edges],edges.back());
 
        a.n->s.insert(e);
        b.n->s.insert(e);
 
        ++n_edges;
        ++next_edge_id;
+
+       return Edge(this,e);
      }
 
-     return Edge(this,e);
+     // already present: return the stored edge, oriented from a to b
+     for (auto e : a.n->s) {
+       if (e->n1 == b.n || e->n2 == b.n) {
+         return Edge(this, e, e->n1 != a.n);
+       }
+     }
+     return Edge();
 
    }
 
@@ -527,14 +561,11 @@ class Graph {
    */
    void clear() {
 
-     // int nn = nodes.size();
-     // for(int i = 0; i < nn; i++){
-     //   delete nodes[i]; // delete memory allocated on the heap
-     // }
-     // int ne = edges.size();
-     // for(int i = 0; i < ne; i++){
-     //   delete edges[i]; // delete memory allocated on the heap
-     // }
+     // drop every record at once by releasing the pools' chunks
+     node_pool.release(nodes.begin(), nodes.end());
+     edge_pool.release(edges.begin(), edges.end());
+     nodes.clear();
+     edges.clear();
 
      n_nodes = 0;
      n_edges = 0;
@@ -629,27 +660,10 @@ class Graph {
     // HW1 #3: YOUR CODE HERE
     // Supply definitions AND SPECIFICATIONS for:
     Edge operator*() const {
-        // edge_element* e = new edge_element{this->n,std::get<0>(*(this->it)),
-        //   (*std::get<1>(*(this->it))).v};
-        edge_element* e;
-
-          // std::cout << "check ID: " << std::endl;
-          if (this->n->id == (*(this->it))->n1->id) {
-            // std::cout <<" id correct" << std::endl;
-            e = new edge_element{this->n,(*(this->it))->n2,
-              (**(this->it)).v,(**(this->it)).idx};
-          }
-          else {
-            if (this->n->id == (*(this->it))->n2->id) {
-              // std::cout <<" id correct" << std::endl;
-              e = new edge_element{this->n,(*(this->it))->n1,
-                (**(this->it)).v,(**(this->it)).idx};
-            }
-            else{
-              // std::cout <<" id swapped" << std::endl;
-            }
-          }
-      return Edge(this->g,e);
+      // Refer to the stored edge record, flipped if needed so that
+      // node1() is this node. No allocation per dereference.
+      edge_element* e = *(this->it);
+      return Edge(this->g, e, e->n1 != this->n);
     }
     IncidentIterator& operator++() {
       ++(this->it);
@@ -745,8 +759,85 @@ class Graph {
      size_type idx;
    };
 
+   /** Fixed-size chunked storage for the graph's node and edge records.
+    *
+    * create() constructs a record in a recycled slot from the free list, or
+    * in the next unused slot of the newest chunk. destroy() runs the
+    * destructor, bumps the slot's generation and pushes the slot onto the
+    * free list. release() drops all chunks at once; it only visits the live
+    * records [first, last) when T has a non-trivial destructor.
+    *
+    * Each slot's generation sits outside the record and the free-list link,
+    * so generation() stays readable for a destroyed record until release().
+    */
+   template <typename T>
+   class element_pool {
+    public:
+     element_pool() : free_(nullptr), used_(chunk_size) {}
+     element_pool(const element_pool&) = delete;
+     element_pool& operator=(const element_pool&) = delete;
+
+     template <typename... Args>
+     T* create(Args&&... args) {
+       void* p;
+       if (free_ != nullptr) {
+         p = free_;
+         free_ = free_->next;
+       }
+       else {
+         if (used_ == chunk_size) {
+           chunks_.emplace_back(new slot[chunk_size]());
+           used_ = 0;
+         }
+         p = &chunks_.back()[used_++];
+       }
+       return new (p) T{std::forward<Args>(args)...};
+     }
+
+     void destroy(T* p) {
+       p->~T();
+       slot* s = reinterpret_cast<slot*>(p);
+       ++s->gen;
+       s->next = free_;
+       free_ = s;
+     }
+
+     /** Return the generation of @a p's slot, or 0 for a null @a p. */
+     static size_type generation(const T* p) {
+       return p == nullptr ? 0 : reinterpret_cast<const slot*>(p)->gen;
+     }
+
+     template <typename It>
+     void release(It first, It last) {
+       if (!std::is_trivially_destructible<T>::value) {
+         for (; first != last; ++first) {
+           (*first)->~T();
+         }
+       }
+       chunks_.clear();
+       free_ = nullptr;
+       used_ = chunk_size;
+     }
+
+    private:
+     static constexpr size_type chunk_size = 1024;
+     // the record comes first, so a T* and its slot* share an address
+     struct slot {
+       union {
+         slot* next;
+         typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+       };
+       size_type gen;
+     };
+     std::vector<std::unique_ptr<slot[]>> chunks_;
+     slot* free_;
+     size_type used_;
+   };
+
    std::vector<node_element*> nodes;
    std::vector<edge_element*> edges;
+   element_pool<node_element> node_pool;
+   element_pool<edge_element> edge_pool;
    size_type next_node_id;
    size_type next_edge_id;
 
@@ -11,6 +11,22 @@
 #include <iterator>
 #include <utility>
 #include <cassert>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #include "CME212/Util.hpp"
 #include "CME212/Point.hpp"
@@ -21,9 +37,19 @@
  *
  * Users can add and retrieve nodes and edges. Edges are unique (there is at
  * most one edge between any pair of distinct nodes).
+ *
+ * @tparam I unsigned integer type used for node and edge indices. Narrow
+ *           types (e.g. uint16_t for small tiles) shrink the edge array
+ *           and the frozen CSR adjacency; the std::map adjacency used
+ *           while not frozen is dominated by per-node map overhead and
+ *           barely shrinks. The graph holds at most
+ *           std::numeric_limits<I>::max() nodes and as many edges.
  */
-template <typename V, typename E>
+template <typename V, typename E, typename I = unsigned>
 class Graph {
+  static_assert(std::is_integral<I>::value and std::is_unsigned<I>::value,
+                "Graph index type must be an unsigned integer type");
+
  private:
 
   struct node_element {
@@ -31,13 +57,132 @@ class Graph {
     node_element(Point point, V value) : p{point}, v{value} {}
   };
   struct edge_element {
-    unsigned n1_id, n2_id; E v;
-    edge_element(unsigned node1, unsigned node2, E value) : n1_id{node1}, n2_id{node2}, v{value} {}
+    I n1_id, n2_id; E v;
+    edge_element(I node1, I node2, E value) : n1_id{node1}, n2_id{node2}, v{value} {}
   };
 
-  std::vector<node_element> nodes;
-  std::vector<edge_element> edges;
-  std::map<unsigned, std::map<unsigned, unsigned>> adjacency;
+  /* @brief vector-like array stored as shared, fixed-size chunks
+   *
+   * Copying a chunked_array copies only the chunk pointers and marks both
+   * sides shared. Reads go through operator[], writes through mut(),
+   * push_back() and pop_back(). While the array is marked shared, a write
+   * first gives the chunk it touches a private copy if anyone else still
+   * holds it; unshare() does that for every chunk at once and clears the
+   * mark, after which writes only test the mark and write in place.
+   * Copy-on-write swaps chunk pointers, so it needs a single writer thread;
+   * several threads may write distinct elements through mut() once the
+   * array is unshared. Copies may be read, and copied, from other threads.
+   */
+  template <typename T>
+  class chunked_array {
+   public:
+    chunked_array() = default;
+    chunked_array(const chunked_array& a)
+      : chunks{a.chunks}, data{a.data}, count{a.count}, shared{not a.chunks.empty()} {
+      if (not chunks.empty()) a.shared.store(true, std::memory_order_relaxed);
+    }
+    chunked_array(chunked_array&& a) noexcept
+      : chunks{std::move(a.chunks)}, data{std::move(a.data)}, count{a.count},
+        shared{a.shared.load(std::memory_order_relaxed)} {
+      a.clear();
+    }
+    chunked_array& operator=(const chunked_array& a) {
+      if (this != &a) *this = chunked_array(a);
+      return *this;
+    }
+    chunked_array& operator=(chunked_array&& a) noexcept {
+      chunks = std::move(a.chunks);
+      data = std::move(a.data);
+      count = a.count;
+      shared.store(a.shared.load(std::memory_order_relaxed), std::memory_order_relaxed);
+      a.clear();
+      return *this;
+    }
+
+    std::size_t size() const { return count; }
+    const T& operator[](std::size_t i) const { return data[i >> chunk_bits][i & chunk_mask]; }
+    const T& back() const { return (*this)[count - 1]; }
+
+    /* @brief return element @a i for writing
+     * Complexity: O(1), or O(chunk size) if its chunk is shared */
+    T& mut(std::size_t i) {
+      if (shared.load(std::memory_order_relaxed)) own(i >> chunk_bits);
+      return data[i >> chunk_bits][i & chunk_mask];
+    }
+
+    void push_back(const T& x) {
+      if ((count & chunk_mask) == 0) {
+        chunks.push_back(std::make_shared<std::vector<T>>());
+        chunks.back()->reserve(chunk_mask + 1);  // never reallocates, so data stays valid
+        data.push_back(chunks.back()->data());
+      }
+      else if (shared.load(std::memory_order_relaxed)) own(count >> chunk_bits);
+      chunks[count >> chunk_bits]->push_back(x);
+      ++count;
+    }
+    void pop_back() {
+      --count;
+      if ((count & chunk_mask) == 0) {  // drop, don't copy
+        chunks.pop_back();
+        data.pop_back();
+        return;
+      }
+      if (shared.load(std::memory_order_relaxed)) own(count >> chunk_bits);
+      chunks[count >> chunk_bits]->pop_back();
+    }
+    void reserve(std::size_t n) {
+      chunks.reserve((n + chunk_mask) >> chunk_bits);
+      data.reserve((n + chunk_mask) >> chunk_bits);
+    }
+    void clear() {
+      chunks.clear();
+      data.clear();
+      count = 0;
+      shared.store(false, std::memory_order_relaxed);
+    }
+
+    /* @brief give every chunk that is still shared a private copy
+     * Complexity: O(size()) if the array is shared, else O(1) */
+    void unshare() {
+      if (not shared.load(std::memory_order_relaxed)) return;
+      for (std::size_t c = 0; c < chunks.size(); ++c) own(c);
+      shared.store(false, std::memory_order_relaxed);
+    }
+
+   private:
+    static constexpr std::size_t chunk_bits = 10;
+    static constexpr std::size_t chunk_mask = (std::size_t(1) << chunk_bits) - 1;
+    std::vector<std::shared_ptr<std::vector<T>>> chunks;
+    std::vector<T*> data;  // chunks[c]->data(), saves a hop on every access
+    std::size_t count = 0;
+    mutable std::atomic<bool> shared{false};  // set by copies, possibly on reader threads
+
+    /* @brief copy chunk @a c first if anyone else still holds it */
+    void own(std::size_t c) {
+      if (chunks[c].use_count() > 1) {
+        auto copy = std::make_shared<std::vector<T>>();
+        copy->reserve(chunk_mask + 1);
+        copy->assign(chunks[c]->begin(), chunks[c]->end());
+        chunks[c] = std::move(copy);
+        data[c] = chunks[c]->data();
+      }
+      // readers that dropped the chunk are done with it before we write
+      else std::atomic_thread_fence(std::memory_order_acquire);
+    }
+  };
+
+  chunked_array<node_element> nodes;
+  chunked_array<edge_element> edges;
+  std::map<I, std::map<I, I>> adjacency;
+
+  // compressed-sparse-row copy of adjacency, only valid while frozen is set:
+  // the neighbors of node i are csr_neighbors[csr_offsets[i] .. csr_offsets[i+1]),
+  // sorted ascending, and csr_edge_ids holds the matching index into edges.
+  // Offsets count 2 * num_edges() entries, so they use std::size_t rather than I.
+  bool frozen = false;
+  std::vector<std::size_t> csr_offsets;
+  std::vector<I> csr_neighbors;
+  std::vector<I> csr_edge_ids;
 
  public:
 
@@ -46,7 +191,7 @@ class Graph {
   //
 
   /** Type of this graph. */
-  using graph_type = Graph<V, E>;
+  using graph_type = Graph<V, E, I>;
 
   /** Predeclaration of Node type. */
   class Node;
@@ -78,8 +223,8 @@ class Graph {
   /** Type of indexes and sizes.
       Return type of Graph::Node::index(), Graph::num_nodes(),
       Graph::num_edges(), and argument type of Graph::node(size_type) */
-  using size_type = unsigned;
-  using mapiterator = typename std::map<unsigned, unsigned>::iterator;
+  using size_type = I;
+  using mapiterator = typename std::map<I, I>::iterator;
 
   //
   // CONSTRUCTORS AND DESTRUCTOR
@@ -122,7 +267,7 @@ class Graph {
     /** Return this node's position. */
     const Point& position() const { return (graph_ptr)->nodes[nid].p; }
 
-    Point& position() { return (graph_ptr)->nodes[nid].p; }
+    Point& position() { return (graph_ptr)->nodes.mut(nid).p; }
 
     /** Return this node's index, a number in the range [0, graph_size). */
     size_type index() const { return nid; }
@@ -130,7 +275,7 @@ class Graph {
     /* @brief return the value of a node
      * @pre method is called by a valid Node
      */
-    node_value_type& value() { return (graph_ptr)->nodes[nid].v; }
+    node_value_type& value() { return (graph_ptr)->nodes.mut(nid).v; }
 
     /* @brief return the value of a node
      * @pre method is called by a valid Node
@@ -142,7 +287,8 @@ class Graph {
      * @post result >= 0 and result == deg(Node)
      */
     size_type degree() const { 
-      if ((graph_ptr)->adjacency.count(nid) > 0) return (graph_ptr)->adjacency.at(nid).size();
+      if (graph_ptr->frozen) return (size_type)(graph_ptr->csr_offsets[nid + 1] - graph_ptr->csr_offsets[nid]);
+      if ((graph_ptr)->adjacency.count(nid) > 0) return (size_type)((graph_ptr)->adjacency.at(nid).size());
       else return 0;
     }
 
@@ -150,12 +296,18 @@ class Graph {
      * @pre Node has at least one adjacent node (one edge incident to it)
      * @post has_edge((*result), Node)
      */
-    incident_iterator edge_begin() const { return incident_iterator(graph_ptr, nid, ((graph_ptr->adjacency).at(nid)).begin()); }
+    incident_iterator edge_begin() const {
+      if (graph_ptr->frozen) return incident_iterator(graph_ptr, nid, graph_ptr->csr_offsets[nid]);
+      return incident_iterator(graph_ptr, nid, ((graph_ptr->adjacency).at(nid)).begin());
+    }
     /* @brief the start point of an iterator for all edge incident to Node
      * @pre Node has at least one adjacent node (one edge incident to it)
      * @post has_edge((*result), Node)
      */
-    incident_iterator edge_end() const { return incident_iterator(graph_ptr, nid, ((graph_ptr->adjacency).at(nid)).end()); }
+    incident_iterator edge_end() const {
+      if (graph_ptr->frozen) return incident_iterator(graph_ptr, nid, graph_ptr->csr_offsets[nid + 1]);
+      return incident_iterator(graph_ptr, nid, ((graph_ptr->adjacency).at(nid)).end());
+    }
 
     /** Test whether this node and @a n are equal.
      *
@@ -201,8 +353,31 @@ class Graph {
    * Complexity: O(1) amortized operations.
    */
   Node add_node(const Point& position, const node_value_type& value = node_value_type()) {
+    assert(nodes.size() < std::numeric_limits<size_type>::max());
     nodes.push_back(node_element(position, value));
-    return Node(this, nodes.size() - 1);
+    if (frozen) csr_offsets.push_back(csr_offsets.back());
+    return Node(this, (size_type)(nodes.size() - 1));
+  }
+
+  /** Add many nodes at once, in order.
+   * @param[in] positions The new nodes' positions
+   * @param[in] values    The new nodes' values; empty for default values
+   * @pre @a values is empty or values.size() == positions.size()
+   * @post new num_nodes() == old num_nodes() + positions.size()
+   * @post node(old num_nodes() + i) has position positions[i]
+   *
+   * Same result as calling add_node() once per position.
+   *
+   * Complexity: O(positions.size()), with a single reallocation.
+   */
+  void add_nodes(const std::vector<Point>& positions,
+                 const std::vector<node_value_type>& values = {}) {
+    assert(values.empty() or values.size() == positions.size());
+    assert(nodes.size() + positions.size() <= std::numeric_limits<size_type>::max());
+    nodes.reserve(nodes.size() + positions.size());
+    for (std::size_t i = 0; i < positions.size(); ++i)
+      nodes.push_back(node_element(positions[i], values.empty() ? node_value_type() : values[i]));
+    if (frozen) csr_offsets.resize(nodes.size() + 1, csr_offsets.back());
   }
 
   /** Determine if a Node belongs to this Graph
@@ -258,13 +433,14 @@ class Graph {
      * std::map<>. It need not have any interpretive meaning.
      */
     bool operator<(const Edge& e) const {
-      if (graph_ptr == e.graph_ptr) return (node1_id * node2_id < e.node1_id * e.node2_id);
+      // compare unordered endpoint pairs, so the order agrees with ==
+      if (graph_ptr == e.graph_ptr) return (std::minmax(node1_id, node2_id) < std::minmax(e.node1_id, e.node2_id));
       else return (graph_ptr < e.graph_ptr);
     }
 
-    edge_value_type& value() { return (graph_ptr->edges).at((graph_ptr->adjacency).at(node1_id).at(node2_id)).v; }
+    edge_value_type& value() { return (graph_ptr->edges).mut(graph_ptr->edge_id(node1_id, node2_id)).v; }
 
-    const edge_value_type& value() const { return (graph_ptr->edges).at((graph_ptr->adjacency).at(node1_id).at(node2_id)).v; }
+    const edge_value_type& value() const { return (graph_ptr->edges)[graph_ptr->edge_id(node1_id, node2_id)].v; }
 
    private:
     // Allow Graph to access Edge's private member data and functions.
@@ -283,7 +459,7 @@ class Graph {
    *
    * Complexity: No more than O(num_nodes() + num_edges()), hopefully less
    */
-  size_type num_edges() const { return edges.size(); }
+  size_type num_edges() const { return (size_type)(edges.size()); }
 
   /** Return the edge with index @a i.
    * @pre 0 <= @a i < num_edges()
@@ -298,7 +474,10 @@ class Graph {
    *
    * Complexity: No more than O(num_nodes() + num_edges()), hopefully less
    */
-  bool has_edge(const Node& a, const Node& b) const { return (adjacency.count(a.nid) > 0 and adjacency.at(a.nid).count(b.nid) > 0); }
+  bool has_edge(const Node& a, const Node& b) const {
+    if (frozen) return csr_find(a.nid, b.nid) != csr_offsets[a.nid + 1];
+    return (adjacency.count(a.nid) > 0 and adjacency.at(a.nid).count(b.nid) > 0);
+  }
 
   /** Add an edge to the graph, or return the current edge if it already exists.
    * @pre @a a and @a b are distinct valid nodes of this graph
@@ -314,36 +493,162 @@ class Graph {
    */
   Edge add_edge(const Node& a, const Node& b, const edge_value_type& value = edge_value_type()) {
     if (has_edge(a, b)) return Edge(this, a, b);
+    assert(edges.size() < std::numeric_limits<size_type>::max());
+    thaw();
     adjacency[a.nid][b.nid] = num_edges(); adjacency[b.nid][a.nid] = num_edges();
     edges.push_back(edge_element(a.nid, b.nid, value));
     return Edge(this, a, b);
   }
 
+  /** Add many edges at once, given as pairs of node indices.
+   * @param[in] pairs  The endpoints (node1, node2) of each edge
+   * @param[in] values The edges' values; empty for default values
+   * @pre @a values is empty or values.size() == pairs.size()
+   * @pre every index in @a pairs is < num_nodes()
+   * @return the number of edges actually added
+   *
+   * Same result as calling add_edge() once per pair, in order: repeated
+   * pairs and pairs already in the graph are skipped, and the first
+   * occurrence decides the edge's orientation, value and index.
+   * The graph is thawed only if a new edge is added.
+   *
+   * Complexity: O(p log p + p log(max degree)) for p = pairs.size(),
+   * instead of a has_edge() lookup and two map insertions per pair.
+   */
+  size_type add_edges(const std::vector<std::pair<size_type, size_type>>& pairs,
+                      const std::vector<edge_value_type>& values = {}) {
+    assert(values.empty() or values.size() == pairs.size());
+
+    // sort pair positions by undirected key, ties by position, so the first
+    // occurrence of each key heads its run
+    auto key = [&pairs](std::size_t k) {
+      return std::minmax(pairs[k].first, pairs[k].second);
+    };
+    std::vector<std::size_t> order(pairs.size());
+    for (std::size_t k = 0; k < order.size(); ++k) order[k] = k;
+    std::sort(order.begin(), order.end(), [&key](std::size_t i, std::size_t j) {
+      return std::make_pair(key(i), i) < std::make_pair(key(j), j);
+    });
+
+    std::vector<std::size_t> fresh;
+    for (std::size_t k = 0; k < order.size(); ++k) {
+      if (k > 0 and key(order[k]) == key(order[k - 1])) continue;
+      const auto& ab = pairs[order[k]];
+      assert(ab.first < num_nodes() and ab.second < num_nodes());
+      if (!has_edge(Node(this, ab.first), Node(this, ab.second))) fresh.push_back(order[k]);
+    }
+    if (fresh.empty()) return 0;
+    std::sort(fresh.begin(), fresh.end());
+
+    assert(edges.size() + fresh.size() <= std::numeric_limits<size_type>::max());
+    thaw();
+    size_type first_id = num_edges();
+    edges.reserve(edges.size() + fresh.size());
+    for (std::size_t k : fresh)
+      edges.push_back(edge_element(pairs[k].first, pairs[k].second,
+                                   values.empty() ? edge_value_type() : values[k]));
+
+    index_edges_from(first_id);
+    return (size_type)(fresh.size());
+  }
+
   /** Remove all nodes and edges from this graph.
    * @post num_nodes() == 0 && num_edges() == 0
    *
    * Invalidates all outstanding Node and Edge objects.
    */
   void clear() {
+    thaw();
     nodes.clear();
     edges.clear();
     adjacency.clear();
   }
 
+  /** @class Graph::Snapshot
+   * @brief Immutable copy of the nodes and edges of a graph at one moment.
+   *
+   * A snapshot holds node data (position, value) and edge data (endpoints,
+   * value) only, read by index as in the graph when the snapshot was taken.
+   * It holds no adjacency: neighbor queries (degree(), edge_begin(),
+   * has_edge(), ...) go to the live graph and see its current state, which
+   * need not match the snapshot. Use edge_nodes() to walk the snapshot's
+   * own edges instead.
+   *
+   * The snapshot shares storage with the graph chunk by chunk, so taking
+   * one costs O(num_nodes() / 1024). The graph copies a chunk of 1024
+   * nodes or edges only when it next writes to it, so a write after a
+   * snapshot costs at most one chunk copy.
+   *
+   * A snapshot is created by the thread that writes the graph. It may then
+   * be read and copied from any thread while the graph keeps changing.
+   * Before writing node or edge values from several threads after taking
+   * a snapshot, call unshare() on the writer thread.
+   */
+  class Snapshot {
+   public:
+    size_type num_nodes() const { return (size_type)(nodes.size()); }
+    size_type num_edges() const { return (size_type)(edges.size()); }
+
+    /* @pre 0 <= @a i < num_nodes() */
+    const Point& position(size_type i) const { return nodes[i].p; }
+    const node_value_type& value(size_type i) const { return nodes[i].v; }
+
+    /* @brief return the node indices of edge @a i
+     * @pre 0 <= @a i < num_edges() */
+    std::pair<size_type, size_type> edge_nodes(size_type i) const {
+      return std::make_pair(edges[i].n1_id, edges[i].n2_id);
+    }
+    const edge_value_type& edge_value(size_type i) const { return edges[i].v; }
+
+   private:
+    friend class Graph;
+    chunked_array<node_element> nodes;
+    chunked_array<edge_element> edges;
+
+    Snapshot(const chunked_array<node_element>& n, const chunked_array<edge_element>& e)
+      : nodes{n}, edges{e} {}
+  };
+
+  /* @brief return an immutable snapshot of the current nodes and edges
+   * @post result.num_nodes() == num_nodes(), result.num_edges() == num_edges()
+   *
+   * Complexity: O((num_nodes() + num_edges()) / 1024).
+   */
+  Snapshot snapshot() const { return Snapshot(nodes, edges); }
+
+  /* @brief stop sharing node and edge storage with any snapshot
+   * @post Writes to node positions and values and edge values are in
+   *       place, and distinct ones may run in parallel, until the next
+   *       snapshot().
+   *
+   * Single-threaded writes copy just the chunk they touch, so only a
+   * write phase that runs on several threads needs to call this first.
+   * Complexity: O(num_nodes() + num_edges()) after a snapshot, else O(1).
+   */
+  void unshare() {
+    nodes.unshare();
+    edges.unshare();
+  }
+
   //
   // Node Iterator
   //
 
   /** @class Graph::NodeIterator
-   * @brief Iterator class for nodes. A forward iterator. */
+   * @brief Iterator class for nodes, over node indices.
+   *
+   * A random-access iterator: +=, -, [] and < are O(1), so std::distance
+   * is O(1) and parallel algorithms and OpenMP loops can split the range.
+   * operator* returns a Node proxy by value, hence reference = Node. */
   class NodeIterator : private totally_ordered<NodeIterator> {
    public:
     // These type definitions let us use STL's iterator_traits.
     using value_type        = Node;                     // Element type
-    using pointer           = Node*;                    // Pointers to elements
-    using reference         = Node&;                    // Reference to elements
+    using pointer           = void;                     // No addressable element
+    using reference         = Node;                     // Proxy, returned by value
     using difference_type   = std::ptrdiff_t;           // Signed difference
-    using iterator_category = std::forward_iterator_tag;  // Weak Category, Proxy
+    using iterator_category = std::random_access_iterator_tag;  // Proxy
+    using iterator_concept  = std::random_access_iterator_tag;  // C++20 concepts
 
     /** Construct an invalid NodeIterator. */
     NodeIterator() {}
@@ -363,6 +668,31 @@ class Graph {
      * @post 0 < (*result).index <= num_nodes()
      */
     bool operator==(const NodeIterator& n) const { return ((graph_ptr == n.graph_ptr) and (id == n.id)); }
+    /* @brief move the iterator one position backward
+     * @pre a valid node iterator not at the beginning
+     */
+    NodeIterator& operator--() { id -= 1; return *this; }
+    NodeIterator operator++(int) { NodeIterator tmp = *this; ++*this; return tmp; }
+    NodeIterator operator--(int) { NodeIterator tmp = *this; --*this; return tmp; }
+    /* @brief move the iterator @a n positions, forward for positive @a n
+     * @pre 0 <= (*this - begin) + @a n <= num_nodes()
+     *
+     * Complexity: O(1); the range can be split for parallel algorithms.
+     */
+    NodeIterator& operator+=(difference_type n) { id = (size_type)(id + n); return *this; }
+    NodeIterator& operator-=(difference_type n) { return *this += -n; }
+    NodeIterator operator+(difference_type n) const { return NodeIterator(*this) += n; }
+    friend NodeIterator operator+(difference_type n, const NodeIterator& it) { return it + n; }
+    NodeIterator operator-(difference_type n) const { return NodeIterator(*this) -= n; }
+    /* @brief return the number of positions from @a it to this iterator
+     * @pre both iterators belong to the same graph
+     */
+    difference_type operator-(const NodeIterator& it) const {
+      return difference_type(id) - difference_type(it.id);
+    }
+    /* @brief return the node @a n positions after the current one */
+    Node operator[](difference_type n) const { return *(*this + n); }
+    bool operator<(const NodeIterator& it) const { return id < it.id; }
 
    private:
     Graph* graph_ptr;
@@ -380,7 +710,7 @@ class Graph {
   /* @brief the start point of an iterator for all edge incident to Node
    * @post (*result).index() == num_nodes
    */
-  node_iterator node_end() const { return node_iterator(this, nodes.size()); }
+  node_iterator node_end() const { return node_iterator(this, (size_type)(nodes.size())); }
 
   //
   // Incident Iterator
@@ -404,27 +734,40 @@ class Graph {
      * @pre a valid source node
      * @post 0 <= (*result).index() < deg(node)
      */
-    Edge operator*() const { return Edge(graph_ptr, Node(graph_ptr, source), Node(graph_ptr, (*it).first)); }
+    Edge operator*() const {
+      if (graph_ptr->frozen) return Edge(graph_ptr, Node(graph_ptr, source), Node(graph_ptr, graph_ptr->csr_neighbors[pos]));
+      return Edge(graph_ptr, Node(graph_ptr, source), Node(graph_ptr, (*it).first));
+    }
     /* @brief move the iterator one position forward
      * @pre a valid source node 
      * @post 0 < (*result).index <= deg(node)
      */
-    IncidentIterator& operator++() { ++it; return *this; }
+    IncidentIterator& operator++() {
+      if (graph_ptr->frozen) ++pos;
+      else ++it;
+      return *this;
+    }
     /* @brief check whether two edges are the same edge
      * @pre a valid source node 
      * @post true if and only if edge.node1 == _i_.node1 and edge.node2 == _i_.node2
      */
     bool operator==(const IncidentIterator& i) const { 
-      return ((graph_ptr == i.graph_ptr) and (source == i.source) and (it == i.it));
+      if ((graph_ptr != i.graph_ptr) or (source != i.source)) return false;
+      if (graph_ptr->frozen) return (pos == i.pos);
+      return (it == i.it);
     }
 
    private:
     Graph* graph_ptr;
     size_type source;
-    mapiterator it;
+    mapiterator it;  // position in adjacency[source] while the graph is mutable
+    std::size_t pos; // position in csr_neighbors while the graph is frozen
 
     IncidentIterator(const Graph* graph, size_type s, mapiterator it_) : 
-      graph_ptr{const_cast<Graph*>(graph)}, source{s}, it{it_} {}
+      graph_ptr{const_cast<Graph*>(graph)}, source{s}, it{it_}, pos{0} {}
+
+    IncidentIterator(const Graph* graph, size_type s, std::size_t pos_) :
+      graph_ptr{const_cast<Graph*>(graph)}, source{s}, it{}, pos{pos_} {}
 
     friend class Graph;
   };
@@ -434,15 +777,20 @@ class Graph {
   //
 
   /** @class Graph::EdgeIterator
-   * @brief Iterator class for edges. A forward iterator. */
+   * @brief Iterator class for edges, over edge indices.
+   *
+   * A random-access iterator: +=, -, [] and < are O(1), so std::distance
+   * is O(1) and parallel algorithms and OpenMP loops can split the range.
+   * operator* returns a Edge proxy by value, hence reference = Edge. */
   class EdgeIterator : private totally_ordered<EdgeIterator> {
    public:
     // These type definitions let us use STL's iterator_traits.
     using value_type        = Edge;                     // Element type
-    using pointer           = Edge*;                    // Pointers to elements
-    using reference         = Edge&;                    // Reference to elements
+    using pointer           = void;                     // No addressable element
+    using reference         = Edge;                     // Proxy, returned by value
     using difference_type   = std::ptrdiff_t;           // Signed difference
-    using iterator_category = std::forward_iterator_tag;  // Weak Category, Proxy
+    using iterator_category = std::random_access_iterator_tag;  // Proxy
+    using iterator_concept  = std::random_access_iterator_tag;  // C++20 concepts
 
     /** Construct an invalid EdgeIterator. */
     EdgeIterator() {}
@@ -465,6 +813,31 @@ class Graph {
      * @post true if and only if two edges have same end nodes
      */
     bool operator==(const EdgeIterator& e) const { return ((graph_ptr == e.graph_ptr) and (id == e.id)); }
+    /* @brief move the iterator one position backward
+     * @pre a valid edge iterator not at the beginning
+     */
+    EdgeIterator& operator--() { id -= 1; return *this; }
+    EdgeIterator operator++(int) { EdgeIterator tmp = *this; ++*this; return tmp; }
+    EdgeIterator operator--(int) { EdgeIterator tmp = *this; --*this; return tmp; }
+    /* @brief move the iterator @a n positions, forward for positive @a n
+     * @pre 0 <= (*this - begin) + @a n <= num_edges()
+     *
+     * Complexity: O(1); the range can be split for parallel algorithms.
+     */
+    EdgeIterator& operator+=(difference_type n) { id = (size_type)(id + n); return *this; }
+    EdgeIterator& operator-=(difference_type n) { return *this += -n; }
+    EdgeIterator operator+(difference_type n) const { return EdgeIterator(*this) += n; }
+    friend EdgeIterator operator+(difference_type n, const EdgeIterator& it) { return it + n; }
+    EdgeIterator operator-(difference_type n) const { return EdgeIterator(*this) -= n; }
+    /* @brief return the number of positions from @a it to this iterator
+     * @pre both iterators belong to the same graph
+     */
+    difference_type operator-(const EdgeIterator& it) const {
+      return difference_type(id) - difference_type(it.id);
+    }
+    /* @brief return the edge @a n positions after the current one */
+    Edge operator[](difference_type n) const { return *(*this + n); }
+    bool operator<(const EdgeIterator& it) const { return id < it.id; }
 
    private:
     Graph* graph_ptr;
@@ -482,7 +855,17 @@ class Graph {
   /* @brief the start point of an iterator for all edges
    * @post (*result).index() == num_edges()
    */
-  edge_iterator edge_end() const { return edge_iterator(this, edges.size()); }
+  edge_iterator edge_end() const { return edge_iterator(this, (size_type)(edges.size())); }
+
+  // node and edge iterators must stay random access; see their class docs
+  static_assert(std::is_same<typename std::iterator_traits<NodeIterator>::iterator_category,
+                             std::random_access_iterator_tag>::value, "NodeIterator must be random access");
+  static_assert(std::is_same<typename std::iterator_traits<EdgeIterator>::iterator_category,
+                             std::random_access_iterator_tag>::value, "EdgeIterator must be random access");
+#if defined(__cpp_lib_concepts)
+  static_assert(std::random_access_iterator<NodeIterator>, "NodeIterator must model random_access_iterator");
+  static_assert(std::random_access_iterator<EdgeIterator>, "EdgeIterator must model random_access_iterator");
+#endif
 
   /** Remove a node from the graph, and return 1 if successful, 0 otherwise.
    * @pre @a n is a node of this graph
@@ -496,39 +879,36 @@ class Graph {
    * Can invalidate node iterators -- in other words, old node_iterator(@ it)
    * might point to a new node (@a n).
    *
-   * Complexity: No more than O(num_nodes())
+   * Complexity: O((deg(n) + deg(last node)) log(max degree))
    */
   size_type remove_node(const Node& n) {
     if (!has_node(n)) return 0;
+    thaw();
 
-    Node last_node = Node(this, num_nodes() - 1);
-
-    if (n.degree() > 0)
-      for (auto e = n.edge_begin(); e != n.edge_end(); ++e) {
-        size_type neighbor = (*e).node2().nid;
-        size_type id = adjacency[n.nid][neighbor];
-
-        edges[id] = edges.back(); edges.pop_back();
+    // collect neighbors first, removing edges mutates adjacency[n]
+    std::vector<size_type> neighbors;
+    for (auto& nb : adjacency[n.nid]) neighbors.push_back(nb.first);
+    for (size_type neighbor : neighbors) remove_edge_id(adjacency[n.nid][neighbor]);
 
-        adjacency[edges[id].n1_id][edges[id].n2_id] = id;
-        adjacency[edges[id].n2_id][edges[id].n1_id] = id;
-        adjacency[neighbor].erase(n.nid);
-      }
-
-    if (last_node.degree() > 0)
-      for (auto e = last_node.edge_begin(); e != last_node.edge_end(); ++e) {
-        size_type neighbor = (*e).node2().nid;
-        size_type id = adjacency[last_node.nid][neighbor];
+    // relabel the last node as n.nid
+    size_type last = num_nodes() - 1;
+    if (n.nid != last) {
+      for (auto& nb : adjacency[last]) {
+        size_type neighbor = nb.first;
+        size_type id = nb.second;
 
-        if (edges[id].n1_id == last_node.nid) edges[id].n1_id = n.nid;
-        if (edges[id].n2_id == last_node.nid) edges[id].n2_id = n.nid;
+        if (edges[id].n1_id == last) edges.mut(id).n1_id = n.nid;
+        if (edges[id].n2_id == last) edges.mut(id).n2_id = n.nid;
 
-        adjacency[neighbor][n.nid] = adjacency[neighbor][last_node.nid];
-        adjacency[neighbor].erase(last_node.nid);
+        adjacency[neighbor][n.nid] = id;
+        adjacency[neighbor].erase(last);
       }
-    adjacency[n.nid] = adjacency[last_node.nid]; adjacency[last_node.nid].clear();
+      adjacency[n.nid] = std::move(adjacency[last]);
+    }
+    adjacency.erase(last);
 
-    nodes[n.nid] = nodes.back(); nodes.pop_back();
+    if (n.nid != last) nodes.mut(n.nid) = nodes.back();
+    nodes.pop_back();
     return 1;
   }
 
@@ -544,7 +924,7 @@ class Graph {
    * Can invalidate node iterators -- in other words, old node_iterator(@ it)
    * might point to a new node (@a n).
    *
-   * Complexity: No more than O(num_nodes())
+   * Complexity: O((deg(n) + deg(last node)) log(max degree))
    */
   node_iterator remove_node(node_iterator n_it) { remove_node(*n_it); return n_it; }
 
@@ -559,20 +939,17 @@ class Graph {
    * Can invalidate edge iterators -- in other words, old edge_iterator(@ it)
    * might point to a new edge (@a e).
    *
-   * Complexity: No more than O(num_nodes() + num_edges())
+   * Complexity: O(log(max degree)), independent of num_edges()
    */
   size_type remove_edge(const Node& a, const Node& b) {
-    for (auto it = edge_begin(); it != edge_end(); ++it)
-      if (((*it).node1() == a and (*it).node2() == b) or ((*it).node1() == b and (*it).node2() == a)) {
+    auto row = adjacency.find(a.nid);
+    if (row == adjacency.end()) return 0;
+    auto nb = row->second.find(b.nid);
+    if (nb == row->second.end()) return 0;
 
-        size_type last_n1_id = edges.back().n1_id; size_type last_n2_id = edges.back().n2_id;
-        adjacency[last_n1_id][last_n2_id] = it.id; adjacency[last_n2_id][last_n1_id] = it.id;
-
-        edges[it.id] = edges.back(); edges.pop_back();
-        adjacency[a.nid].erase(b.nid); adjacency[b.nid].erase(a.nid);
-        return 1;
-      }
-    return 0;
+    thaw();
+    remove_edge_id(nb->second);
+    return 1;
   }
 
   /** Remove an edge from the graph, and return 1 if successful or 0 otherwise.
@@ -586,7 +963,7 @@ class Graph {
    * Can invalidate edge iterators -- in other words, old edge_iterator(@ it)
    * might point to a new edge (@a e).
    *
-   * Complexity: No more than O(num_nodes() + num_edges())
+   * Complexity: O(log(max degree)), independent of num_edges()
    */
   size_type remove_edge(const Edge& e) { return remove_edge(e.node1(), e.node2()); }
 
@@ -601,11 +978,372 @@ class Graph {
    * Can invalidate edge iterators -- in other words, old edge_iterator(@ e_it)
    * might point to a new edge (@a e_it).
    *
-   * Complexity: No more than O(num_nodes() + num_edges())
+   * Complexity: O(log(max degree)), independent of num_edges()
    */
-  edge_iterator remove_edge(edge_iterator e_it) { remove_edge(*e_it); return e_it; }
+  edge_iterator remove_edge(edge_iterator e_it) { thaw(); remove_edge_id(e_it.id); return e_it; }
+
+  /** Freeze the current topology into contiguous compressed-sparse-row arrays.
+   * @post is_frozen() == true
+   *
+   * While frozen, degree(), has_edge(), Edge::value() and incident iteration
+   * read flat arrays instead of walking the adjacency maps. Node, Edge and
+   * iterator objects keep working unchanged. Any add_edge, remove_node,
+   * remove_edge or clear() drops the frozen arrays and returns the graph to
+   * its mutable representation; call freeze() again once topology settles.
+   * Node positions and node/edge values can be modified while frozen, and
+   * add_node() keeps the arrays, giving the new node no neighbors.
+   *
+   * Complexity: O(num_nodes() + num_edges())
+   */
+  void freeze() {
+    csr_offsets.assign(num_nodes() + 1, 0);
+    csr_neighbors.clear(); csr_neighbors.reserve(2 * num_edges());
+    csr_edge_ids.clear(); csr_edge_ids.reserve(2 * num_edges());
+
+    auto adj = adjacency.begin();
+    for (size_type i = 0; i < num_nodes(); ++i) {
+      csr_offsets[i] = csr_neighbors.size();
+      while (adj != adjacency.end() and adj->first < i) ++adj;
+      if (adj != adjacency.end() and adj->first == i)
+        for (auto& nb : adj->second) {
+          csr_neighbors.push_back(nb.first);
+          csr_edge_ids.push_back(nb.second);
+        }
+    }
+    csr_offsets[num_nodes()] = csr_neighbors.size();
+    frozen = true;
+  }
+
+  /* @brief return true if the graph currently holds frozen CSR arrays */
+  bool is_frozen() const { return frozen; }
+
+  //
+  // Binary file format
+  //
+  // Native byte order, each section padded to a multiple of 8 bytes:
+  //   header    "CME212GR", u32 version, u32 flags, u32 sizeof(I), u32 0,
+  //             u64 num_nodes, u64 num_edges
+  //   positions num_nodes * 3 doubles
+  //   values    u64 byte count, then the node value codec's output
+  //   edges     num_edges * 2 node indices of type I
+  //   values    u64 byte count, then the edge value codec's output
+  //   CSR       only if flags & 1: (num_nodes + 1) u64 offsets, then
+  //             2 * num_edges neighbors and 2 * num_edges edge ids of type I
+  //
+
+  /* @brief value codec that stores trivially copyable values verbatim
+   *
+   * A codec provides encode(value, out), appending bytes to the string
+   * out, and decode(p, end), reading one value from [p, end) and advancing
+   * p, or returning false if the bytes are malformed. Write a codec with
+   * this interface for value types that are not trivially copyable.
+   */
+  template <typename T>
+  struct raw_codec {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "raw_codec needs a trivially copyable type; pass a custom codec");
+    void encode(const T& x, std::string& out) const {
+      out.append(reinterpret_cast<const char*>(&x), sizeof(T));
+    }
+    bool decode(const char*& p, const char* end, T& x) const {
+      if (std::size_t(end - p) < sizeof(T)) return false;
+      std::memcpy(&x, p, sizeof(T));
+      p += sizeof(T);
+      return true;
+    }
+  };
+
+  /** Write this graph to the file @a path in the binary format above.
+   * @param[in] with_csr   Also store the CSR adjacency, so that load()
+   *                       returns an already frozen graph
+   * @return true on success, false if the file could not be written
+   *
+   * Complexity: O(num_nodes() + num_edges()), plus a freeze() if
+   * @a with_csr is set and the graph is not frozen.
+   */
+  template <typename NodeCodec = raw_codec<V>, typename EdgeCodec = raw_codec<E>>
+  bool save(const std::string& path, bool with_csr = false,
+            const NodeCodec& node_codec = NodeCodec(),
+            const EdgeCodec& edge_codec = EdgeCodec()) {
+    if (with_csr and !frozen) freeze();
+    std::string out;
+    out.append(file_magic, 8);
+    put<std::uint32_t>(out, std::uint32_t(file_version));
+    put<std::uint32_t>(out, with_csr ? 1 : 0);
+    put<std::uint32_t>(out, sizeof(I));
+    put<std::uint32_t>(out, 0);
+    put<std::uint64_t>(out, num_nodes());
+    put<std::uint64_t>(out, num_edges());
+
+    for (size_type i = 0; i < num_nodes(); ++i)
+      for (int k = 0; k < 3; ++k) put<double>(out, nodes[i].p[k]);
+    put_values(out, nodes, node_codec);
+    for (size_type i = 0; i < num_edges(); ++i) {
+      put<I>(out, edges[i].n1_id);
+      put<I>(out, edges[i].n2_id);
+    }
+    pad(out);
+    put_values(out, edges, edge_codec);
+    if (with_csr) {
+      for (std::size_t off : csr_offsets) put<std::uint64_t>(out, off);
+      for (I nb : csr_neighbors) put<I>(out, nb);
+      for (I id : csr_edge_ids) put<I>(out, id);
+      pad(out);
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(out.data(), out.size());
+    return bool(file);
+  }
+
+  /** Replace the contents of this graph by the graph stored in @a path.
+   * @return true on success. On failure (missing file, wrong magic,
+   *         version or index type, truncated or inconsistent data, or an
+   *         edge stored twice) the graph is left empty and false is returned.
+   * @post on success the graph equals the saved one, node and edge
+   *       indices included, and is_frozen() iff it was saved with its CSR
+   *
+   * The file is memory-mapped where the platform allows and decoded in one
+   * pass; adjacency is built row by row instead of through add_edge.
+   * Invalidates all outstanding Node and Edge objects.
+   *
+   * Complexity: O(num_nodes() + num_edges() log(max degree)).
+   */
+  template <typename NodeCodec = raw_codec<V>, typename EdgeCodec = raw_codec<E>>
+  bool load(const std::string& path,
+            const NodeCodec& node_codec = NodeCodec(),
+            const EdgeCodec& edge_codec = EdgeCodec()) {
+    clear();
+    mapped_file file(path);
+    if (!file.data or !read_graph(file.data, file.data + file.size, node_codec, edge_codec)) {
+      clear();
+      return false;
+    }
+    return true;
+  }
 
  private:
+  static constexpr const char* file_magic = "CME212GR";
+  static constexpr std::uint32_t file_version = 1;
+
+  /* @brief read-only view of a whole file, memory-mapped if possible */
+  struct mapped_file {
+    const char* data = nullptr;
+    std::size_t size = 0;
+#if defined(__unix__) || defined(__APPLE__)
+    explicit mapped_file(const std::string& path) {
+      int fd = ::open(path.c_str(), O_RDONLY);
+      if (fd < 0) return;
+      struct stat st;
+      if (::fstat(fd, &st) == 0 and st.st_size > 0) {
+        void* p = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) { data = static_cast<const char*>(p); size = st.st_size; }
+      }
+      ::close(fd);
+    }
+    ~mapped_file() { if (data) ::munmap(const_cast<char*>(data), size); }
+#else
+    std::string buffer;
+    explicit mapped_file(const std::string& path) {
+      std::ifstream file(path, std::ios::binary);
+      if (!file) return;
+      buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+      if (!buffer.empty()) { data = buffer.data(); size = buffer.size(); }
+    }
+#endif
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+  };
+
+  template <typename T>
+  static void put(std::string& out, const T& x) {
+    out.append(reinterpret_cast<const char*>(&x), sizeof(T));
+  }
+  /* @brief read a T at @a p and advance, or return false if past @a end */
+  template <typename T>
+  static bool get(const char*& p, const char* end, T& x) {
+    if (std::size_t(end - p) < sizeof(T)) return false;
+    std::memcpy(&x, p, sizeof(T));
+    p += sizeof(T);
+    return true;
+  }
+  static void pad(std::string& out) { out.resize((out.size() + 7) & ~std::size_t(7)); }
+  static bool skip_pad(const char*& p, const char* begin, const char* end) {
+    std::size_t at = ((p - begin) + 7) & ~std::size_t(7);
+    if (at > std::size_t(end - begin)) return false;
+    p = begin + at;
+    return true;
+  }
+
+  /* @brief append the .v of every element of @a elements as a length-prefixed block */
+  template <typename Array, typename Codec>
+  static void put_values(std::string& out, const Array& elements, const Codec& codec) {
+    std::size_t at = out.size();
+    put<std::uint64_t>(out, 0);
+    for (std::size_t i = 0; i < elements.size(); ++i) codec.encode(elements[i].v, out);
+    std::uint64_t bytes = out.size() - at - sizeof(std::uint64_t);
+    std::memcpy(&out[at], &bytes, sizeof(bytes));
+    pad(out);
+  }
+
+  /* @brief decode a whole file image into this empty graph */
+  template <typename NodeCodec, typename EdgeCodec>
+  bool read_graph(const char* begin, const char* end,
+                  const NodeCodec& node_codec, const EdgeCodec& edge_codec) {
+    const char* p = begin;
+    char magic[8];
+    std::uint32_t version, flags, index_size, reserved;
+    std::uint64_t n, m, bytes;
+    if (!get(p, end, magic) or std::memcmp(magic, file_magic, 8) != 0) return false;
+    if (!get(p, end, version) or version != file_version) return false;
+    if (!get(p, end, flags) or !get(p, end, index_size) or index_size != sizeof(I)) return false;
+    if (!get(p, end, reserved) or !get(p, end, n) or !get(p, end, m)) return false;
+    if (n > std::numeric_limits<size_type>::max() or m > std::numeric_limits<size_type>::max())
+      return false;
+    if (std::size_t(end - p) / (3 * sizeof(double)) < n) return false;
+
+    // nodes: positions, then values
+    const char* pos = p;
+    p += n * 3 * sizeof(double);
+    if (!get(p, end, bytes) or bytes > std::size_t(end - p)) return false;
+    const char* vals = p;
+    const char* vals_end = p + bytes;
+    nodes.reserve(n);
+    for (std::uint64_t i = 0; i < n; ++i) {
+      double xyz[3];
+      std::memcpy(xyz, pos + i * sizeof(xyz), sizeof(xyz));
+      node_value_type v;
+      if (!node_codec.decode(vals, vals_end, v)) return false;
+      nodes.push_back(node_element(Point(xyz[0], xyz[1], xyz[2]), v));
+    }
+    p = vals_end;
+    if (!skip_pad(p, begin, end)) return false;
+
+    // edges: endpoints, then values
+    if (std::size_t(end - p) / (2 * sizeof(I)) < m) return false;
+    const char* ends = p;
+    p += m * 2 * sizeof(I);
+    if (!skip_pad(p, begin, end)) return false;
+    if (!get(p, end, bytes) or bytes > std::size_t(end - p)) return false;
+    vals = p;
+    vals_end = p + bytes;
+    edges.reserve(m);
+    for (std::uint64_t i = 0; i < m; ++i) {
+      I ab[2];
+      std::memcpy(ab, ends + i * sizeof(ab), sizeof(ab));
+      if (ab[0] >= n or ab[1] >= n or ab[0] == ab[1]) return false;
+      edge_value_type v;
+      if (!edge_codec.decode(vals, vals_end, v)) return false;
+      edges.push_back(edge_element(ab[0], ab[1], v));
+    }
+    p = vals_end;
+    if (!skip_pad(p, begin, end)) return false;
+
+    if (!(flags & 1)) {
+      index_edges_from(0);
+      // a pair stored twice collapses into one adjacency entry per side
+      std::size_t entries = 0;
+      for (auto& row : adjacency) entries += row.second.size();
+      return entries == 2 * m;
+    }
+
+    // stored CSR: adopt it, and fill each adjacency row from its sorted CSR row
+    if (std::size_t(end - p) / sizeof(std::uint64_t) < n + 1) return false;
+    csr_offsets.resize(n + 1);
+    for (std::uint64_t i = 0; i <= n; ++i) {
+      std::uint64_t off;
+      get(p, end, off);
+      if (off > 2 * m or (i > 0 and off < csr_offsets[i - 1])) return false;
+      csr_offsets[i] = off;
+    }
+    if (csr_offsets[0] != 0 or csr_offsets[n] != 2 * m) return false;
+    if (std::size_t(end - p) / (2 * sizeof(I)) < 2 * m) return false;
+    csr_neighbors.resize(2 * m);
+    csr_edge_ids.resize(2 * m);
+    std::memcpy(csr_neighbors.data(), p, 2 * m * sizeof(I));
+    std::memcpy(csr_edge_ids.data(), p + 2 * m * sizeof(I), 2 * m * sizeof(I));
+    for (size_type i = 0; i < n; ++i) {
+      if (csr_offsets[i] == csr_offsets[i + 1]) continue;
+      auto& row = adjacency[i];
+      for (std::size_t k = csr_offsets[i]; k < csr_offsets[i + 1]; ++k) {
+        I nb = csr_neighbors[k], id = csr_edge_ids[k];
+        if (nb >= n or id >= m or (k > csr_offsets[i] and nb <= csr_neighbors[k - 1])) return false;
+        if (!((edges[id].n1_id == i and edges[id].n2_id == nb) or
+              (edges[id].n2_id == i and edges[id].n1_id == nb))) return false;
+        row.emplace_hint(row.end(), nb, id);
+      }
+    }
+    frozen = true;
+    return true;
+  }
+
+  /* @brief add both adjacency entries of edges[@a first_id ..] to adjacency
+   *
+   * Entries are grouped by node and sorted by neighbor, so each row is
+   * filled with hinted appends. Complexity: O(k log k) for k new edges.
+   */
+  void index_edges_from(size_type first_id) {
+    std::vector<std::pair<std::pair<size_type, size_type>, size_type>> entries;
+    entries.reserve(2 * (num_edges() - first_id));
+    for (size_type id = first_id; id < num_edges(); ++id) {
+      entries.push_back({{edges[id].n1_id, edges[id].n2_id}, id});
+      entries.push_back({{edges[id].n2_id, edges[id].n1_id}, id});
+    }
+    std::sort(entries.begin(), entries.end());
+    for (std::size_t k = 0; k < entries.size(); ) {
+      auto& row = adjacency[entries[k].first.first];
+      std::size_t end = k;
+      for (; end < entries.size() and entries[end].first.first == entries[k].first.first; ++end)
+        row.emplace_hint(row.end(), entries[end].first.second, entries[end].second);
+      k = end;
+    }
+  }
+
+  /* @brief drop the frozen CSR arrays before the topology is modified */
+  void thaw() {
+    if (!frozen) return;
+    frozen = false;
+    csr_offsets.clear(); csr_neighbors.clear(); csr_edge_ids.clear();
+  }
+
+  /* @brief remove edges[@a id] by swapping the last edge into its slot
+   * @pre 0 <= @a id < num_edges() and graph is not frozen
+   * @post the edge formerly at num_edges() - 1 now has index @a id
+   *
+   * Complexity: O(log(max degree)), four adjacency lookups
+   */
+  void remove_edge_id(size_type id) {
+    size_type a = edges[id].n1_id, b = edges[id].n2_id;
+    adjacency[a].erase(b); adjacency[b].erase(a);
+
+    if (id != edges.size() - 1) {
+      edges.mut(id) = edges.back();
+      adjacency[edges[id].n1_id][edges[id].n2_id] = id;
+      adjacency[edges[id].n2_id][edges[id].n1_id] = id;
+    }
+    edges.pop_back();
+  }
+
+  /* @brief return the position of neighbor @a b in the CSR row of @a a
+   * @pre graph is frozen
+   * @post result == csr_offsets[a+1] if @a a and @a b are not adjacent
+   */
+  std::size_t csr_find(size_type a, size_type b) const {
+    auto first = csr_neighbors.begin() + csr_offsets[a];
+    auto last = csr_neighbors.begin() + csr_offsets[a + 1];
+    auto it = std::lower_bound(first, last, b);
+    if (it == last or *it != b) return csr_offsets[a + 1];
+    return it - csr_neighbors.begin();
+  }
+
+  /* @brief return the index into edges of the edge between @a a and @a b
+   * @pre @a a and @a b are adjacent
+   */
+  size_type edge_id(size_type a, size_type b) const {
+    if (frozen) return csr_edge_ids[csr_find(a, b)];
+    return adjacency.at(a).at(b);
+  }
+
   void graph_test() {
     for (auto e = edge_begin(); e != edge_end(); ++e) {
       Edge e1 = *e;
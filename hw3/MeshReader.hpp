@@ -0,0 +1,353 @@
+#ifndef CME212_MESHREADER_HPP
+#define CME212_MESHREADER_HPP
+
+/** @file MeshReader.hpp
+ * @brief Multithreaded reader for .nodes/.tets mesh files
+ */
+
+#include <algorithm>
+#include <vector>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <future>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "CME212/Point.hpp"
+
+
+/** @struct MeshReadStats
+ * @brief Line count and per-stage wall time of one MeshReader::read().
+ *
+ * parse_tets runs concurrently with add_nodes, so the stage times can add
+ * up to more than total.
+ */
+struct MeshReadStats {
+  std::size_t node_lines = 0;
+  std::size_t tet_lines = 0;
+  std::size_t edges = 0;          // distinct edges emitted by the tets
+  double read = 0;                // both files into memory
+  double parse_nodes = 0;         // text to Points
+  double add_nodes = 0;           // Points into the graph
+  double parse_tets = 0;          // text to deduplicated edge buckets
+  double dedupe = 0;              // merge of the buckets across threads
+  double add_edges = 0;           // edges into the graph
+  double total = 0;
+
+  /** Return the number of input lines read per second of total time. */
+  double lines_per_second() const {
+    return total > 0 ? (node_lines + tet_lines) / total : 0;
+  }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const MeshReadStats& s) {
+  os << (s.node_lines + s.tet_lines) << " lines in " << s.total << " s ("
+     << s.lines_per_second() << " lines/s), " << s.edges << " edges\n"
+     << "  read        " << s.read << " s\n"
+     << "  parse nodes " << s.parse_nodes << " s\n"
+     << "  add nodes   " << s.add_nodes << " s\n"
+     << "  parse tets  " << s.parse_tets << " s (overlaps add nodes)\n"
+     << "  dedupe      " << s.dedupe << " s\n"
+     << "  add edges   " << s.add_edges << " s\n";
+  return os;
+}
+
+
+/** @class MeshReader
+ * @brief Builds a graph from a node file and a tetrahedron file in parallel.
+ *
+ * The node file holds one "x y z" line per node; the tet file one "a b c d"
+ * line of node indices per tetrahedron, and each tet contributes its six
+ * sides as edges. Blank lines are skipped and anything after the expected
+ * numbers on a line is ignored, as with CME212::getline_parsed.
+ *
+ * Each file is read into memory whole and cut into chunks at line breaks.
+ * Worker threads parse the chunks; node positions are copied into the graph
+ * with one add_nodes() call while the tet chunks are still being parsed.
+ * Tet sides are normalized to (min, max), spread over a fixed number of
+ * buckets by their first index, and sorted and deduplicated per bucket, so
+ * the graph gets each edge once through one add_edges() call. The result
+ * does not depend on the number of threads.
+ *
+ * G needs add_nodes(std::vector<Point>) and
+ * add_edges(std::vector<std::pair<size_type, size_type>>), as in
+ * hw3/Graph_707.hpp.
+ *
+ * @code
+ * MeshReader<GraphType> reader;
+ * if (!reader.read(graph, "data/tet4.nodes", "data/tet4.tets")) ...
+ * std::cout << reader.stats();
+ * @endcode
+ */
+template <typename G>
+class MeshReader {
+ public:
+  using size_type = typename G::size_type;
+  using edge_list = std::vector<std::pair<size_type, size_type>>;
+
+  /** Construct a reader that uses @a threads worker threads, or one per
+   *  hardware thread if 0.
+   */
+  explicit MeshReader(unsigned threads = 0)
+      : threads_(threads ? threads : std::max(1u, std::thread::hardware_concurrency())) {}
+
+  /** Add the nodes of @a nodes_path and the tet edges of @a tets_path to
+   *  @a graph.
+   * @return true on success; false if a file cannot be read, a line does
+   *         not parse, or a tet refers to a node not in the file. On
+   *         failure the graph may hold the nodes but none of the edges.
+   * @post node(old num_nodes() + i) has the position on line i of the
+   *       node file, counting non-blank lines from 0
+   *
+   * Tet indices are relative to the node file, so reading into a nonempty
+   * graph offsets them by its old num_nodes().
+   *
+   * Complexity: O((L + E log E) / threads + N + E log(max degree)) for L
+   * input lines and E tet sides, plus the cost of add_edges().
+   */
+  bool read(G& graph, const std::string& nodes_path, const std::string& tets_path) {
+    stats_ = MeshReadStats();
+    auto start = clock::now();
+    auto t = start;
+
+    std::string node_text, tet_text;
+    if (!slurp(nodes_path, node_text) or !slurp(tets_path, tet_text)) return false;
+    stats_.read = lap(t);
+
+    std::vector<Point> points;
+    if (!parse_nodes(node_text, points)) return false;
+    stats_.parse_nodes = lap(t);
+    stats_.node_lines = points.size();
+
+    // tets are parsed by the workers while this thread fills in the nodes
+    std::vector<std::array<edge_list, buckets>> tet_edges;
+    auto tets_done = std::async(std::launch::async, [&]() {
+      auto t0 = clock::now();
+      bool ok = parse_tets(tet_text, tet_edges);
+      stats_.parse_tets = lap(t0);
+      return ok;
+    });
+    size_type base = graph.num_nodes();
+    graph.add_nodes(points);
+    stats_.add_nodes = lap(t);
+    bool ok = tets_done.get();
+    t = clock::now();
+    if (!ok) return false;
+
+    edge_list edges;
+    if (!merge(tet_edges, size_type(points.size()), base, edges)) return false;
+    stats_.dedupe = lap(t);
+    stats_.edges = edges.size();
+
+    graph.add_edges(edges);
+    stats_.add_edges = lap(t);
+    stats_.total = std::chrono::duration<double>(clock::now() - start).count();
+    return true;
+  }
+
+  /** Return the statistics of the last read(). */
+  const MeshReadStats& stats() const { return stats_; }
+
+ private:
+  using clock = std::chrono::steady_clock;
+  // Edge buckets; fixed so that the edge order is the same for any thread count
+  static constexpr std::size_t buckets = 64;
+
+  unsigned threads_;
+  MeshReadStats stats_;
+
+  /** Return the seconds since @a t and reset @a t to now. */
+  static double lap(clock::time_point& t) {
+    auto now = clock::now();
+    double s = std::chrono::duration<double>(now - t).count();
+    t = now;
+    return s;
+  }
+
+  /** Read the whole file @a path into @a text. */
+  static bool slurp(const std::string& path, std::string& text) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+    text.resize(std::size_t(file.tellg()));
+    file.seekg(0);
+    file.read(&text[0], text.size());
+    return bool(file);
+  }
+
+  /** Call f(k) for k in [0, count), spread over the worker threads. */
+  template <typename F>
+  void parallel_for(std::size_t count, F f) const {
+    std::atomic<std::size_t> next(0);
+    auto work = [&]() {
+      for (std::size_t k; (k = next++) < count; ) f(k);
+    };
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < std::min<std::size_t>(threads_, count); ++i)
+      pool.emplace_back(work);
+    work();
+    for (auto& th : pool) th.join();
+  }
+
+  /** Cut @a text into about 4 chunks per thread, each ending after a '\n'.
+   *  Returns the chunk boundaries, from 0 to text.size().
+   */
+  std::vector<std::size_t> chunks(const std::string& text) const {
+    std::size_t target = std::max<std::size_t>(text.size() / (4 * threads_), 1 << 16);
+    std::vector<std::size_t> bounds(1, 0);
+    while (bounds.back() < text.size()) {
+      std::size_t at = bounds.back() + target;
+      if (at >= text.size()) at = text.size();
+      else at = std::min(text.find('\n', at), text.size() - 1) + 1;
+      bounds.push_back(at);
+    }
+    return bounds;
+  }
+
+  /** Call f(begin, end) on each line of [@a p, @a end) that is not blank.
+   *  Stops and returns false as soon as f does.
+   */
+  template <typename F>
+  static bool for_each_line(const char* p, const char* end, F f) {
+    while (p < end) {
+      const char* eol = std::find(p, end, '\n');
+      const char* q = p;
+      while (q < eol and (*q == ' ' or *q == '\t' or *q == '\r')) ++q;
+      if (q < eol and !f(q, eol)) return false;
+      p = eol + 1;
+    }
+    return true;
+  }
+
+  /** Parse @a n doubles from the line [@a p, @a eol) into @a out. */
+  static bool parse_doubles(const char* p, const char* eol, double* out, int n) {
+    for (int i = 0; i < n; ++i) {
+      while (p < eol and (*p == ' ' or *p == '\t')) ++p;
+      if (p == eol) return false;
+      char* q;
+      out[i] = std::strtod(p, &q);
+      if (q == p or q > eol) return false;
+      p = q;
+    }
+    return true;
+  }
+
+  /** Parse @a n unsigned indices from the line [@a p, @a eol) into @a out. */
+  static bool parse_indices(const char* p, const char* eol, size_type* out, int n) {
+    for (int i = 0; i < n; ++i) {
+      while (p < eol and (*p == ' ' or *p == '\t')) ++p;
+      if (p == eol or *p < '0' or *p > '9') return false;
+      char* q;
+      unsigned long long x = std::strtoull(p, &q, 10);
+      if (q > eol or x > std::numeric_limits<size_type>::max()) return false;
+      out[i] = size_type(x);
+      p = q;
+    }
+    return true;
+  }
+
+  /** Parse the node file, chunks in parallel, into @a points in file order. */
+  bool parse_nodes(const std::string& text, std::vector<Point>& points) const {
+    auto bounds = chunks(text);
+    std::vector<std::vector<Point>> parts(bounds.size() - 1);
+    std::atomic<bool> ok(true);
+    parallel_for(parts.size(), [&](std::size_t c) {
+      auto& part = parts[c];
+      part.reserve((bounds[c + 1] - bounds[c]) / 24);
+      bool good = for_each_line(text.data() + bounds[c], text.data() + bounds[c + 1],
+                                [&part](const char* p, const char* eol) {
+        double x[3];
+        if (!parse_doubles(p, eol, x, 3)) return false;
+        part.push_back(Point(x[0], x[1], x[2]));
+        return true;
+      });
+      if (!good) ok = false;
+    });
+    if (!ok) return false;
+
+    std::vector<std::size_t> offset(parts.size() + 1, 0);
+    for (std::size_t c = 0; c < parts.size(); ++c)
+      offset[c + 1] = offset[c] + parts[c].size();
+    points.resize(offset.back());
+    parallel_for(parts.size(), [&](std::size_t c) {
+      std::copy(parts[c].begin(), parts[c].end(), points.begin() + offset[c]);
+    });
+    return true;
+  }
+
+  /** Parse the tet file, chunks in parallel, into one set of sorted and
+   *  deduplicated edge buckets per chunk.
+   */
+  bool parse_tets(const std::string& text,
+                  std::vector<std::array<edge_list, buckets>>& parts) {
+    auto bounds = chunks(text);
+    parts.assign(bounds.size() - 1, std::array<edge_list, buckets>());
+    std::vector<std::size_t> lines(parts.size(), 0);
+    std::atomic<bool> ok(true);
+    parallel_for(parts.size(), [&](std::size_t c) {
+      auto& part = parts[c];
+      bool good = for_each_line(text.data() + bounds[c], text.data() + bounds[c + 1],
+                                [&](const char* p, const char* eol) {
+        size_type t[4];
+        if (!parse_indices(p, eol, t, 4)) return false;
+        ++lines[c];
+        for (int i = 0; i < 4; ++i)
+          for (int j = i + 1; j < 4; ++j) {
+            if (t[i] == t[j]) continue;
+            auto e = std::minmax(t[i], t[j]);
+            part[e.first % buckets].push_back(e);
+          }
+        return true;
+      });
+      if (!good) ok = false;
+      for (auto& b : part) {
+        std::sort(b.begin(), b.end());
+        b.erase(std::unique(b.begin(), b.end()), b.end());
+      }
+    });
+    for (std::size_t n : lines) stats_.tet_lines += n;
+    return ok;
+  }
+
+  /** Merge the per-chunk buckets into @a edges, one bucket per task,
+   *  dropping duplicates across chunks and offsetting indices by @a base.
+   * @return false if an index is not less than @a num_points
+   */
+  bool merge(std::vector<std::array<edge_list, buckets>>& parts,
+             size_type num_points, size_type base, edge_list& edges) const {
+    std::array<edge_list, buckets> merged;
+    std::atomic<bool> ok(true);
+    parallel_for(buckets, [&](std::size_t b) {
+      auto& out = merged[b];
+      std::size_t n = 0;
+      for (auto& part : parts) n += part[b].size();
+      out.reserve(n);
+      for (auto& part : parts) {
+        out.insert(out.end(), part[b].begin(), part[b].end());
+        edge_list().swap(part[b]);
+      }
+      std::sort(out.begin(), out.end());
+      out.erase(std::unique(out.begin(), out.end()), out.end());
+      for (auto& e : out) {
+        if (e.second >= num_points) ok = false;
+        e.first += base;
+        e.second += base;
+      }
+    });
+    if (!ok) return false;
+
+    std::size_t n = 0;
+    for (auto& b : merged) n += b.size();
+    edges.reserve(n);
+    for (auto& b : merged) edges.insert(edges.end(), b.begin(), b.end());
+    return true;
+  }
+};
+
+#endif // CME212_MESHREADER_HPP
@@ -0,0 +1,109 @@
+/** @file index_width_bench.cpp
+ * @brief Memory footprint and traversal throughput of Graph_707.hpp for
+ *        16-, 32- and 64-bit index types.
+ *
+ * Builds the same 3D grid mesh with each index type and reports the heap
+ * bytes the graph holds, with and without its frozen CSR arrays, and the
+ * rate at which all incident edges are visited through IncidentIterator.
+ * The mesh stays below 65535 nodes and edges so that 16-bit ids fit.
+ *
+ * Build: g++ -std=c++14 -O3 -I<dir with CME212/> index_width_bench.cpp
+ * Usage: ./a.out [passes]
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "Graph_707.hpp"
+
+// Count live heap bytes by wrapping every allocation in a size header.
+// All forms of new and delete go through the same pair of functions, so
+// every block is freed by the function that allocated it.
+static std::size_t live_bytes = 0;
+
+static void* counted_alloc(std::size_t n) {
+  void* p = std::malloc(n + 16);
+  if (!p) throw std::bad_alloc();
+  *static_cast<std::size_t*>(p) = n;
+  live_bytes += n;
+  return static_cast<char*>(p) + 16;
+}
+static void counted_free(void* p) noexcept {
+  if (!p) return;
+  char* q = static_cast<char*>(p) - 16;
+  live_bytes -= *reinterpret_cast<std::size_t*>(q);
+  std::free(q);
+}
+
+void* operator new(std::size_t n) { return counted_alloc(n); }
+void* operator new[](std::size_t n) { return counted_alloc(n); }
+void operator delete(void* p) noexcept { counted_free(p); }
+void operator delete[](void* p) noexcept { counted_free(p); }
+void operator delete(void* p, std::size_t) noexcept { counted_free(p); }
+void operator delete[](void* p, std::size_t) noexcept { counted_free(p); }
+
+/** Sum neighbor indices over every incident edge of every node, @a passes
+ *  times, and print the rate.
+ */
+template <typename G>
+void traverse(const G& g, int passes, const char* label) {
+  std::uint64_t sum = 0, visits = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int pass = 0; pass < passes; ++pass)
+    for (unsigned i = 0; i < g.num_nodes(); ++i) {
+      auto n = g.node(i);
+      for (auto it = n.edge_begin(); it != n.edge_end(); ++it) {
+        sum += (*it).node2().index();
+        ++visits;
+      }
+    }
+  double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  std::cout << "  " << label << visits / s / 1e6 << " M edges/s (checksum " << sum << ")\n";
+}
+
+template <typename I>
+void run(int side, int passes) {
+  Graph<int, int, I> g;
+
+  std::vector<Point> points;
+  for (int z = 0; z < side; ++z)
+    for (int y = 0; y < side; ++y)
+      for (int x = 0; x < side; ++x)
+        points.push_back(Point(x, y, z));
+  std::vector<std::pair<I, I>> pairs;
+  auto id = [side](int x, int y, int z) { return I((z * side + y) * side + x); };
+  for (int z = 0; z < side; ++z)
+    for (int y = 0; y < side; ++y)
+      for (int x = 0; x < side; ++x) {
+        if (x + 1 < side) pairs.push_back({id(x, y, z), id(x + 1, y, z)});
+        if (y + 1 < side) pairs.push_back({id(x, y, z), id(x, y + 1, z)});
+        if (z + 1 < side) pairs.push_back({id(x, y, z), id(x, y, z + 1)});
+      }
+  std::size_t scratch = live_bytes;
+  g.add_nodes(points);
+  g.add_edges(pairs);
+  std::size_t mutable_bytes = live_bytes - scratch;
+
+  std::cout << 8 * sizeof(I) << "-bit ids: " << g.num_nodes() << " nodes, "
+            << g.num_edges() << " edges\n";
+  std::cout << "  maps     " << mutable_bytes << " bytes\n";
+  traverse(g, passes, "maps     ");
+  g.freeze();
+  std::cout << "  +CSR     " << live_bytes - scratch << " bytes\n";
+  traverse(g, passes, "CSR      ");
+}
+
+int main(int argc, char** argv) {
+  int passes = argc > 1 ? std::atoi(argv[1]) : 20;
+  // 27^3 = 19683 nodes and 3 * 27^2 * 26 = 56862 edges fit in 16 bits
+  const int side = 27;
+  run<std::uint16_t>(side, passes);
+  run<std::uint32_t>(side, passes);
+  run<std::uint64_t>(side, passes);
+  return 0;
+}